@@ -1,15 +1,120 @@
-﻿#include <bitset>
+﻿#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <bitset>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <future>
 #include <iostream>
-#include <cassert>
 #include <chrono>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GF2M_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define GF2M_TARGET_CLMUL
+#else
+#include <cpuid.h>
+#define GF2M_TARGET_CLMUL __attribute__((target("pclmul,sse2")))
+// GCC/Clang дозволяють скомпілювати ядро під кілька наборів інструкцій і обрати його під час виконання
+#define GF2M_MULTIVERSION 1
+#define GF2M_TARGET_AVX2 __attribute__((target("avx2")))
+#define GF2M_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __GNUC__
+#define GF2M_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define GF2M_ALWAYS_INLINE __forceinline
+#endif
+
+// Степінь розширення за замовчуванням
 const int m = 173;
 
-using MultiplicativeMatrix = std::vector<std::bitset<m>>;
+// Кількість 64-бітних слів (limbs), у яких зберігається елемент поля
+template <int M>
+constexpr int limbCount = (M + 63) / 64;
+
+// Маска старшого слова: біти з номерами >= M завжди нульові
+template <int M>
+constexpr uint64_t topMask = (M % 64) ? ((static_cast<uint64_t>(1) << (M % 64)) - 1) : ~static_cast<uint64_t>(0);
+
+// Кількість 4-бітних груп у нормальному (біти 0..M-1) та палиндромному (біти 0..M) представленнях
+template <int M>
+constexpr int nibbleCount = (M + 3) / 4;
+template <int M>
+constexpr int palindromicNibbleCount = (M + 4) / 4;
+
+template <int M>
+using Limbs = std::array<uint64_t, limbCount<M>>;
+// Добуток двох многочленів з limbCount<M> слів
+template <int M>
+using WideLimbs = std::array<uint64_t, 2 * limbCount<M>>;
+template <int M>
+using MultiplicativeMatrix = std::array<Limbs<M>, M>;
+
+// Розріджена форма матриці множення ONB типу II. Матриця симетрична, має 2M - 1 одиниць,
+// у кожному рядку одна або дві. pairs - симетричні пари (j, k), (k, j) поза діагоналлю,
+// oddRow - єдиний рядок з однією одиницею.
+template <int M>
+struct SparseMatrix {
+    int oddRow;
+    std::array<std::pair<int, int>, M - 1> pairs;
+};
+
+// Перестановка бітів між нормальним базисом та палиндромним представленням, по 4 біти
+template <int M>
+struct PalindromicTables {
+    std::array<std::array<Limbs<M>, 16>, nibbleCount<M>> to;
+    std::array<std::array<Limbs<M>, 16>, palindromicNibbleCount<M>> from;
+};
+
+// Реалізація множення. Polynomial* переводять елементи у палиндромне представлення
+// та множать їх як многочлени без переносів (carry-less), програмно або інструкцією PCLMULQDQ.
+enum class MultiplyBackend {
+    Sparse,
+    PolynomialScalar,
+    PolynomialClmul
+};
 
-int custom_clz(uint32_t x) {
+constexpr int custom_clz(uint32_t x) {
     if (x == 0) return 32; // якщо чиcло 0, повертаємо 32 (вcі біти нульові)
 
     int leading_zeros = 0;
@@ -24,467 +129,4410 @@ int custom_clz(uint32_t x) {
     return leading_zeros;
 }
 
-int mod_pow2(int exponent, int mod) {
-    int result = 1;
-    for (int i = 0; i < exponent; ++i) {
-        result = (result << 1) % mod;
+constexpr bool isPrime(int n) {
+    if (n < 2) return false;
+    for (int d = 2; d * d <= n; ++d) {
+        if (n % d == 0) return false;
     }
-    return result;
+    return true;
+}
+
+// Порядок двійки за модулем p
+constexpr int orderOfTwo(int p) {
+    int order = 1;
+    for (int x = 2 % p; x != 1; x = (x * 2) % p) ++order;
+    return order;
+}
+
+// ONB типу II існує, якщо p = 2M + 1 просте і 2 є первісним коренем за модулем p (тип IIa)
+// або p = 3 mod 4 і 2 породжує квадратичні лишки (тип IIb)
+constexpr bool isOptimalNormalBasisTypeII(int M) {
+    int p = 2 * M + 1;
+    if (!isPrime(p)) return false;
+    int order = orderOfTwo(p);
+    return order == 2 * M || (order == M && p % 4 == 3);
+}
+
+// Ланцюжок додавань: values[0] = 1, values[k] = values[steps[k].first] + values[steps[k].second]
+struct AdditionChain {
+    int length;
+    std::array<int, 64> values;
+    std::array<std::pair<int, int>, 64> steps;
+};
+
+// Бінарний ланцюжок для n: подвоєння на кожен біт після старшого та +1 на кожну одиницю
+constexpr AdditionChain calculateAdditionChain(int n) {
+    AdditionChain chain{};
+    chain.values[0] = 1;
+    chain.length = 1;
+    for (int i = 30 - custom_clz(static_cast<uint32_t>(n)); i >= 0; --i) {
+        int last = chain.length - 1;
+        chain.steps[chain.length] = { last, last };
+        chain.values[chain.length] = 2 * chain.values[last];
+        ++chain.length;
+        if (n & (1 << i)) {
+            chain.steps[chain.length] = { chain.length - 1, 0 };
+            chain.values[chain.length] = chain.values[chain.length - 1] + 1;
+            ++chain.length;
+        }
+    }
+    return chain;
+}
+
+// Матриця множення: одиниця у рядку M - i - 1, стовпці M - j - 1, якщо 2^i +- 2^j = +-1 (mod p)
+template <int M>
+constexpr MultiplicativeMatrix<M> calculateMultiplicativeMatrix() {
+    const int p = 2 * M + 1;
+    std::array<int, M> powers{};
+    powers[0] = 1;
+    for (int i = 1; i < M; ++i) powers[i] = (powers[i - 1] * 2) % p;
+
+    MultiplicativeMatrix<M> matrix{};
+    for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < M; ++j) {
+            int two_i = powers[i];
+            int two_j = powers[j];
+
+            if ((two_i + two_j) % p == 1 ||
+                (two_i - two_j + p) % p == 1 ||
+                ((p - two_i) + two_j) % p == 1 ||
+                ((p - two_i) - two_j + p) % p == 1) {
+                int row = M - i - 1, col = M - j - 1;
+                matrix[row][col / 64] |= static_cast<uint64_t>(1) << (col % 64);
+            }
+        }
+    }
+    return matrix;
+}
+
+// Витягуємо з матриці індекси одиниць. Біт t добутку дорівнює сумі по
+// одиницях (j, k) добутків a[(t + j + 1) mod M] * b[(t + k + 1) mod M]. Позначимо
+// A_j = a.rotate(j + 1), B_j = b.rotate(j + 1); тоді симетрична пара дає
+// A_j B_k + A_k B_j = (A_j + A_k)(B_j + B_k) + A_j B_j + A_k B_k. Разом з діагональними
+// одиницями доданок A_j B_j входить стільки разів, скільки одиниць у рядку j, тож
+// залишається лише рядок з непарною кількістю одиниць (Reyhani-Masoleh, Hasan).
+template <int M>
+constexpr SparseMatrix<M> calculateSparseMatrix(const MultiplicativeMatrix<M>& matrix) {
+    SparseMatrix<M> sparse{};
+    int pairCount = 0, oddCount = 0;
+    for (int j = 0; j < M; ++j) {
+        int count = 0;
+        for (int k = 0; k < M; ++k) {
+            if (!((matrix[j][k / 64] >> (k % 64)) & 1)) continue;
+            ++count;
+            if (j < k) {
+                if (pairCount == M - 1) throw std::logic_error("Матриця множення не відповідає ONB типу II");
+                sparse.pairs[pairCount++] = { j, k };
+            }
+        }
+        if (count == 0 || count > 2) {
+            throw std::logic_error("Матриця множення не відповідає ONB типу II");
+        }
+        if (count % 2) {
+            sparse.oddRow = j;
+            ++oddCount;
+        }
+    }
+    if (oddCount != 1 || pairCount != M - 1) {
+        throw std::logic_error("Матриця множення не відповідає ONB типу II");
+    }
+    return sparse;
+}
+
+// Для ONB типу II beta = g + g^-1, де g - корінь степеня p = 2M + 1 з одиниці.
+// Тоді beta^(2^s) = e_j = g^j + g^-j, де j = min(2^s mod p, p - 2^s mod p) пробігає 1..M,
+// а e_i * e_k = e_(i+k) + e_|i-k|. Елемент a = sum a_j e_j зберігаємо як многочлен
+// sum a_j x^j (біти 1..M); біт b нормального базису відповідає степеню s = M - 1 - b.
+template <int M>
+constexpr PalindromicTables<M> calculatePalindromicTables() {
+    const int p = 2 * M + 1;
+    std::array<int, M> permutation{};
+    int power = 1;
+    for (int s = 0; s < M; ++s) {
+        permutation[M - 1 - s] = power < p - power ? power : p - power;
+        power = (power * 2) % p;
+    }
+    PalindromicTables<M> tables{};
+    for (int q = 0; q < nibbleCount<M>; ++q) {
+        for (int v = 0; v < 16; ++v) {
+            for (int r = 0; r < 4; ++r) {
+                int bit = 4 * q + r;
+                if (((v >> r) & 1) && bit < M) {
+                    int j = permutation[bit];
+                    tables.to[q][v][j / 64] |= static_cast<uint64_t>(1) << (j % 64);
+                }
+            }
+        }
+    }
+    std::array<int, M + 1> inverse{};
+    for (int bit = 0; bit < M; ++bit) inverse[permutation[bit]] = bit;
+    for (int q = 0; q < palindromicNibbleCount<M>; ++q) {
+        for (int v = 0; v < 16; ++v) {
+            for (int r = 0; r < 4; ++r) {
+                int j = 4 * q + r;
+                if (((v >> r) & 1) && j >= 1 && j <= M) {
+                    int bit = inverse[j];
+                    tables.from[q][v][bit / 64] |= static_cast<uint64_t>(1) << (bit % 64);
+                }
+            }
+        }
+    }
+    return tables;
+}
+
+// Зсув праворуч на k біт (0 <= k < M): фіксована кількість операцій над словами
+template <int M>
+Limbs<M> shiftRight(const Limbs<M>& x, int k) {
+    const int words = limbCount<M>;
+    Limbs<M> r{};
+    int w = k / 64, b = k % 64;
+    for (int i = 0; i < words; ++i) {
+        uint64_t lo = (i + w < words) ? x[i + w] : 0;
+        uint64_t hi = (i + w + 1 < words) ? x[i + w + 1] : 0;
+        r[i] = b ? (lo >> b) | (hi << (64 - b)) : lo;
+    }
+    return r;
+}
+
+// Зсув ліворуч на k біт (0 <= k < M) з обрізанням бітів за межами M
+template <int M>
+Limbs<M> shiftLeft(const Limbs<M>& x, int k) {
+    const int words = limbCount<M>;
+    Limbs<M> r{};
+    int w = k / 64, b = k % 64;
+    for (int i = 0; i < words; ++i) {
+        uint64_t lo = (i - w >= 0) ? x[i - w] : 0;
+        uint64_t prev = (i - w - 1 >= 0) ? x[i - w - 1] : 0;
+        r[i] = b ? (lo << b) | (prev >> (64 - b)) : lo;
+    }
+    r[words - 1] &= topMask<M>;
+    return r;
+}
+
+// Циклічний зсув праворуч на 1 біт (піднесення до квадрату) лише з константними зсувами
+template <int M>
+inline Limbs<M> rotateRightOne(const Limbs<M>& x) {
+    const int words = limbCount<M>;
+    Limbs<M> r;
+    for (int i = 0; i < words - 1; ++i) {
+        r[i] = (x[i] >> 1) | (x[i + 1] << 63);
+    }
+    r[words - 1] = (x[words - 1] >> 1) | ((x[0] & 1) << ((M - 1) % 64));
+    return r;
+}
+
+inline uint64_t bitReverse64(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+    return (x >> 32) | (x << 32);
+}
+
+// Дзеркальне відображення бітів 0..M: біт r переходить у біт M - r
+template <int M>
+inline Limbs<M> reverseHalf(const Limbs<M>& x) {
+    const int words = limbCount<M>;
+    const int shift = words * 64 - (M + 1);
+    static_assert(words * 64 - (M + 1) >= 0, "Палиндромне представлення має вміщатися у limbCount<M> слів");
+    Limbs<M> t, r;
+    for (int i = 0; i < words; ++i) t[i] = bitReverse64(x[words - 1 - i]);
+    for (int i = 0; i < words; ++i) {
+        uint64_t next = (i + 1 < words) ? t[i + 1] : 0;
+        r[i] = (t[i] >> shift) | ((next << 1) << (63 - shift));
+    }
+    return r;
+}
+
+// Молодші limbCount<M> слів подвійного числа, зсунутого праворуч на k біт
+template <int M>
+inline Limbs<M> wideShiftRight(const WideLimbs<M>& x, int k) {
+    const int words = limbCount<M>;
+    Limbs<M> r;
+    int w = k / 64, b = k % 64;
+    for (int i = 0; i < words; ++i) {
+        uint64_t next = (i + w + 1 < 2 * words) ? x[i + w + 1] : 0;
+        r[i] = (x[i + w] >> b) | ((next << 1) << (63 - b));
+    }
+    return r;
+}
+
+// Програмне множення 64x64 -> 128 біт без переносів (вікно 4 біти)
+inline void clmul64Scalar(uint64_t a, uint64_t b, uint64_t& lo, uint64_t& hi) {
+    uint64_t tableLo[16], tableHi[16];
+    tableLo[0] = 0;
+    tableHi[0] = 0;
+    for (int k = 1; k < 16; ++k) {
+        // k * b = (k / 2) * b * x + (k mod 2) * b
+        tableLo[k] = (tableLo[k >> 1] << 1) ^ ((k & 1) ? b : 0);
+        tableHi[k] = (tableHi[k >> 1] << 1) | (tableLo[k >> 1] >> 63);
+    }
+    lo = 0;
+    hi = 0;
+    for (int i = 60; i >= 0; i -= 4) {
+        hi = (hi << 4) | (lo >> 60);
+        lo <<= 4;
+        int nibble = static_cast<int>((a >> i) & 0xF);
+        lo ^= tableLo[nibble];
+        hi ^= tableHi[nibble];
+    }
+}
+
+template <size_t N>
+inline std::array<uint64_t, 2 * N> clmulLimbsScalar(const std::array<uint64_t, N>& a, const std::array<uint64_t, N>& b) {
+    std::array<uint64_t, 2 * N> r{};
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            uint64_t lo, hi;
+            clmul64Scalar(a[i], b[j], lo, hi);
+            r[i + j] ^= lo;
+            r[i + j + 1] ^= hi;
+        }
+    }
+    return r;
+}
+
+#ifdef GF2M_X86
+template <size_t N>
+GF2M_TARGET_CLMUL inline std::array<uint64_t, 2 * N> clmulLimbsHardware(const std::array<uint64_t, N>& a, const std::array<uint64_t, N>& b) {
+    std::array<uint64_t, 2 * N> r{};
+    for (size_t i = 0; i < N; ++i) {
+        __m128i x = _mm_set_epi64x(0, static_cast<long long>(a[i]));
+        for (size_t j = 0; j < N; ++j) {
+            __m128i y = _mm_set_epi64x(0, static_cast<long long>(b[j]));
+            alignas(16) uint64_t p[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(p), _mm_clmulepi64_si128(x, y, 0x00));
+            r[i + j] ^= p[0];
+            r[i + j + 1] ^= p[1];
+        }
+    }
+    return r;
+}
+#endif
+
+bool cpuSupportsClmul() {
+#ifdef GF2M_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 1)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    return (ecx & bit_PCLMUL) != 0;
+#endif
+#else
+    return false;
+#endif
 }
 
+// Необов'язкові лічильники операцій поля, компілюються лише з -DGF2M_INSTRUMENT.
+// Кожен потік рахує виклики у власних лічильниках без блокувань; кожен sampleInterval-й виклик
+// операції ще й вимірює тривалість у гістограмі з кошиками по степенях двійки наносекунд.
+// Виклики всередині інших операцій теж рахуються: множення в inverse, а також множення через
+// Accumulator (pow, FixedBasePow) і FusedSum (innerProduct).
+// Операції GF2mBatch рахуються по одному виклику на весь пакет (lanes*), parallel_map,
+// parallel_reduce та parallel_inverse - по одному виклику на всі елементи (parallel).
+#ifdef GF2M_INSTRUMENT
+#define GF2M_INSTRUMENT_OP(operation) Instrumentation::Probe gf2mProbe(FieldOperation::operation)
+
+enum class FieldOperation { Multiply, Square, Inverse, Pow, BatchInverse, LanesMultiply, LanesInverse, LanesPow, Parallel, Count };
+
+class Instrumentation {
+public:
+    static constexpr int operations = static_cast<int>(FieldOperation::Count);
+    // Кошик b містить тривалості з [2^b, 2^(b+1)) нс, кошик 0 - також коротші за 1 нс
+    static constexpr int buckets = 32;
+
+    static const char* operationName(FieldOperation operation) {
+        static const char* const names[operations] = { "multiply", "square", "inverse", "pow", "batchInverse",
+                                                        "lanesMultiply", "lanesInverse", "lanesPow", "parallel" };
+        return names[static_cast<int>(operation)];
+    }
+
+    struct Histogram {
+        uint64_t samples = 0, totalNs = 0, maxNs = 0;
+        std::array<uint64_t, buckets> counts{};
+
+        // Верхня межа кошика, у який потрапляє перцентиль q (0 < q <= 1)
+        uint64_t percentileNs(double q) const {
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(samples) + 0.999999), seen = 0;
+            for (int b = 0; b < buckets; ++b) {
+                seen += counts[b];
+                if (seen >= rank && seen > 0) return std::min(maxNs, (static_cast<uint64_t>(2) << b) - 1);
+            }
+            return 0;
+        }
+    };
+
+    using OperationCounts = std::array<uint64_t, operations>;
+
+    // Рядок у лапках з екрануванням за правилами JSON
+    static std::string jsonString(const std::string& text) {
+        static const char hex[] = "0123456789abcdef";
+        std::string quoted = "\"";
+        for (char c : text) {
+            unsigned char u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+                quoted += c;
+            }
+            else if (u < 0x20) {
+                quoted += "\\u00";
+                quoted += hex[u >> 4];
+                quoted += hex[u & 0xF];
+            }
+            else {
+                quoted += c;
+            }
+        }
+        return quoted + "\"";
+    }
+
+    struct Snapshot {
+        OperationCounts calls{};
+        std::array<Histogram, operations> latency{};
+        // Сумарні виклики в межах кожної названої фази (Scope), у порядку першої появи
+        std::vector<std::pair<std::string, OperationCounts>> scopes;
+
+        std::string toText() const {
+            std::string text = "операція: виклики, виміряно, середнє / p50 / p99 / max нс\n";
+            for (int op = 0; op < operations; ++op) {
+                const Histogram& h = latency[op];
+                text += std::string(operationName(static_cast<FieldOperation>(op))) + ": " + std::to_string(calls[op]) + ", " + std::to_string(h.samples) + ", "
+                    + std::to_string(h.samples ? h.totalNs / h.samples : 0) + " / " + std::to_string(h.percentileNs(0.5)) + " / "
+                    + std::to_string(h.percentileNs(0.99)) + " / " + std::to_string(h.maxNs) + "\n";
+            }
+            for (const auto& [name, counts] : scopes) {
+                text += "фаза " + name + ":";
+                for (int op = 0; op < operations; ++op) {
+                    text += std::string(" ") + operationName(static_cast<FieldOperation>(op)) + "=" + std::to_string(counts[op]);
+                }
+                text += "\n";
+            }
+            return text;
+        }
+
+        std::string toJson() const {
+            std::string json = "{\"operations\": {";
+            for (int op = 0; op < operations; ++op) {
+                const Histogram& h = latency[op];
+                json += std::string(op ? ", " : "") + "\"" + operationName(static_cast<FieldOperation>(op)) + "\": {\"calls\": " + std::to_string(calls[op])
+                    + ", \"sampled\": " + std::to_string(h.samples) + ", \"meanNs\": " + std::to_string(h.samples ? h.totalNs / h.samples : 0)
+                    + ", \"p50Ns\": " + std::to_string(h.percentileNs(0.5)) + ", \"p99Ns\": " + std::to_string(h.percentileNs(0.99))
+                    + ", \"maxNs\": " + std::to_string(h.maxNs) + ", \"histogram\": [";
+                for (int b = 0; b < buckets; ++b) json += (b ? ", " : "") + std::to_string(h.counts[b]);
+                json += "]}";
+            }
+            json += "}, \"scopes\": {";
+            for (size_t i = 0; i < scopes.size(); ++i) {
+                json += std::string(i ? ", " : "") + jsonString(scopes[i].first) + ": {";
+                for (int op = 0; op < operations; ++op) {
+                    json += std::string(op ? ", " : "") + "\"" + operationName(static_cast<FieldOperation>(op)) + "\": " + std::to_string(scopes[i].second[op]);
+                }
+                json += "}";
+            }
+            return json + "}}";
+        }
+    };
+
+    class Scope;
+
+private:
+    // Лічильники фази в одному потоці. Probe збільшує лише лічильник поточного кадру потоку,
+    // без атомарних операцій і без обходу вкладених фаз; кадр зливається у фазу при завершенні.
+    struct Frame {
+        Scope* scope;
+        Frame* parent;
+        OperationCounts counts{};
+    };
+
+public:
+    // Фаза виконання: поки об'єкт живий, операції поля в цьому потоці приписуються їй.
+    // Підрахунок включний: вкладена фаза при завершенні додає свої лічильники до зовнішньої
+    // фази того самого потоку, тож зовнішня фаза містить і виклики всіх вкладених.
+    // Задачі ThreadPool::parallelFor виконуються у фазі викликача (Bind): кожна задача рахує у
+    // власному кадрі робочого потоку і додає підсумок до фази один раз, коли задача завершується.
+    // Після завершення фази її лічильники додаються до знімка під іменем name.
+    class Scope {
+        std::string name;
+        Frame frame;
+        // Підсумки задач з інших потоків (Bind)
+        std::array<std::atomic<uint64_t>, operations> merged{};
+
+        friend class Instrumentation;
+
+    public:
+        explicit Scope(std::string name) : name(std::move(name)), frame{ this, currentFrame } {
+            currentFrame = &frame;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() {
+            currentFrame = frame.parent;
+            OperationCounts total;
+            for (int op = 0; op < operations; ++op) total[op] = calls(static_cast<FieldOperation>(op));
+            if (frame.parent) {
+                for (int op = 0; op < operations; ++op) frame.parent->counts[op] += total[op];
+            }
+            std::lock_guard<std::mutex> lock(registryMutex);
+            auto it = std::find_if(scopeTotals.begin(), scopeTotals.end(), [&](const auto& entry) { return entry.first == name; });
+            if (it == scopeTotals.end()) it = scopeTotals.insert(scopeTotals.end(), { name, OperationCounts{} });
+            for (int op = 0; op < operations; ++op) it->second[op] += total[op];
+        }
+
+        // Виклики в цьому потоці та в уже завершених задачах з Bind; викликати з потоку фази
+        uint64_t calls(FieldOperation operation) const {
+            int op = static_cast<int>(operation);
+            return frame.counts[op] + merged[op].load(std::memory_order_relaxed);
+        }
+
+        static Scope* current() {
+            return currentFrame ? currentFrame->scope : nullptr;
+        }
+
+        // Поки об'єкт живий, операції цього потоку приписуються фазі scope (може бути nullptr)
+        class Bind {
+            Frame frame;
+
+        public:
+            explicit Bind(Scope* scope) : frame{ scope, currentFrame } {
+                currentFrame = &frame;
+            }
+
+            Bind(const Bind&) = delete;
+            Bind& operator=(const Bind&) = delete;
 
+            ~Bind() {
+                currentFrame = frame.parent;
+                if (!frame.scope) return;
+                for (int op = 0; op < operations; ++op) {
+                    if (frame.counts[op]) frame.scope->merged[op].fetch_add(frame.counts[op], std::memory_order_relaxed);
+                }
+            }
+        };
+    };
+
+    // Вимірювання одного виклику; створюється макросом GF2M_INSTRUMENT_OP на початку операції
+    class Probe {
+        int op;
+        bool sampled;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit Probe(FieldOperation operation) : op(static_cast<int>(operation)) {
+            ThreadCounters& counters = threadCounters();
+            bump(counters.calls[op], 1);
+            if (currentFrame) ++currentFrame->counts[op];
+            sampled = ++counters.ticks[op] >= sampleInterval.load(std::memory_order_relaxed);
+            if (sampled) {
+                counters.ticks[op] = 0;
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        Probe(const Probe&) = delete;
+        Probe& operator=(const Probe&) = delete;
+
+        ~Probe() {
+            if (!sampled) return;
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            uint64_t ns = static_cast<uint64_t>(std::max<decltype(elapsed)>(elapsed, 0));
+            ThreadCounters& counters = threadCounters();
+            bump(counters.samples[op], 1);
+            bump(counters.totalNs[op], ns);
+            if (ns > counters.maxNs[op].load(std::memory_order_relaxed)) counters.maxNs[op].store(ns, std::memory_order_relaxed);
+            bump(counters.histogram[op][std::min(buckets - 1, ns ? static_cast<int>(std::bit_width(ns)) - 1 : 0)], 1);
+        }
+    };
+
+    // Вимірювати тривалість кожного interval-го виклику (1 - кожного)
+    static void setSampleInterval(uint32_t interval) {
+        sampleInterval.store(std::max<uint32_t>(interval, 1), std::memory_order_relaxed);
+    }
+
+    // Сума лічильників усіх живих та завершених потоків
+    static Snapshot snapshot() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        Snapshot result;
+        accumulate(result, retired());
+        for (const ThreadCounters* counters : live) accumulate(result, *counters);
+        result.scopes = scopeTotals;
+        return result;
+    }
+
+    // Обнуляє всі лічильники; виклики, що виконуються одночасно зі скиданням, можуть загубитися
+    static void reset() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        clear(retired());
+        for (ThreadCounters* counters : live) clear(*counters);
+        scopeTotals.clear();
+    }
+
+private:
+    // Кожне поле пише лише потік-власник, тож достатньо load + store без атомарного RMW;
+    // атомарність потрібна лише для читання знімка з іншого потоку
+    struct ThreadCounters {
+        std::array<std::atomic<uint64_t>, operations> calls{}, samples{}, totalNs{}, maxNs{};
+        std::array<std::array<std::atomic<uint64_t>, buckets>, operations> histogram{};
+        std::array<uint32_t, operations> ticks{};
+    };
+
+    // Реєструє лічильники потоку; при завершенні потоку переносить їх у retired
+    struct ThreadRegistration {
+        ThreadCounters counters;
+
+        ThreadRegistration() {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            live.push_back(&counters);
+        }
+
+        ~ThreadRegistration() {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            live.erase(std::find(live.begin(), live.end(), &counters));
+            ThreadCounters& total = retired();
+            for (int op = 0; op < operations; ++op) {
+                bump(total.calls[op], counters.calls[op].load(std::memory_order_relaxed));
+                bump(total.samples[op], counters.samples[op].load(std::memory_order_relaxed));
+                bump(total.totalNs[op], counters.totalNs[op].load(std::memory_order_relaxed));
+                total.maxNs[op].store(std::max(total.maxNs[op].load(std::memory_order_relaxed), counters.maxNs[op].load(std::memory_order_relaxed)), std::memory_order_relaxed);
+                for (int b = 0; b < buckets; ++b) bump(total.histogram[op][b], counters.histogram[op][b].load(std::memory_order_relaxed));
+            }
+        }
+    };
+
+    // Лічильники поточного потоку, реєструються при першому виклику
+    static ThreadCounters& threadCounters() {
+        thread_local ThreadRegistration registration;
+        return registration.counters;
+    }
+
+    // Накопичені лічильники завершених потоків
+    static ThreadCounters& retired() {
+        static ThreadCounters counters;
+        return counters;
+    }
+
+    static void bump(std::atomic<uint64_t>& counter, uint64_t delta) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    static void accumulate(Snapshot& result, const ThreadCounters& counters) {
+        for (int op = 0; op < operations; ++op) {
+            Histogram& h = result.latency[op];
+            result.calls[op] += counters.calls[op].load(std::memory_order_relaxed);
+            h.samples += counters.samples[op].load(std::memory_order_relaxed);
+            h.totalNs += counters.totalNs[op].load(std::memory_order_relaxed);
+            h.maxNs = std::max(h.maxNs, counters.maxNs[op].load(std::memory_order_relaxed));
+            for (int b = 0; b < buckets; ++b) h.counts[b] += counters.histogram[op][b].load(std::memory_order_relaxed);
+        }
+    }
+
+    static void clear(ThreadCounters& counters) {
+        for (int op = 0; op < operations; ++op) {
+            counters.calls[op].store(0, std::memory_order_relaxed);
+            counters.samples[op].store(0, std::memory_order_relaxed);
+            counters.totalNs[op].store(0, std::memory_order_relaxed);
+            counters.maxNs[op].store(0, std::memory_order_relaxed);
+            for (int b = 0; b < buckets; ++b) counters.histogram[op][b].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static inline std::mutex registryMutex;
+    static inline std::vector<ThreadCounters*> live;
+    static inline std::vector<std::pair<std::string, OperationCounts>> scopeTotals;
+    static inline std::atomic<uint32_t> sampleInterval{ 64 };
+    static inline thread_local Frame* currentFrame = nullptr;
+};
+#else
+#define GF2M_INSTRUMENT_OP(operation) ((void)0)
+#endif
+
+
+// Елемент поля GF(2^M) у оптимальному нормальному базисі типу II.
+// Усі таблиці будуються під час компіляції, тож ініціалізація перед використанням не потрібна.
+template <int M = m>
 class GF2m {
+    static_assert(isOptimalNormalBasisTypeII(M), "Для цього M не існує оптимального нормального базису типу II");
+
+public:
+    static constexpr int words = limbCount<M>;
+    static constexpr int nibbles = nibbleCount<M>;
+    static constexpr int palindromicNibbles = palindromicNibbleCount<M>;
+    // Ширина вікна pow: ~M / (window + 1) множень плюс 2^(window-1) на таблицю, мінімум при 4
+    static constexpr int powWindow = 4;
+    static constexpr int maxPowWindow = 8;
+    // Розміри текстового та двійкового подання елемента
+    static constexpr int hexDigits = (M + 3) / 4;
+    static constexpr int binaryBytes = (M + 7) / 8;
+
 private:
-    std::bitset<m> value;
-    static MultiplicativeMatrix multiplicativeMatrix;
+    Limbs<M> value;
+    static constexpr MultiplicativeMatrix<M> multiplicativeMatrix = calculateMultiplicativeMatrix<M>();
+    static constexpr SparseMatrix<M> sparseMatrix = calculateSparseMatrix<M>(multiplicativeMatrix);
+    static constexpr PalindromicTables<M> palindromicTables = calculatePalindromicTables<M>();
+    static constexpr std::array<int8_t, 256> hexDigitValues = [] {
+        std::array<int8_t, 256> table{};
+        table.fill(-1);
+        for (int c = '0'; c <= '9'; ++c) table[c] = static_cast<int8_t>(c - '0');
+        for (int c = 'A'; c <= 'F'; ++c) table[c] = static_cast<int8_t>(c - 'A' + 10);
+        for (int c = 'a'; c <= 'f'; ++c) table[c] = static_cast<int8_t>(c - 'a' + 10);
+        return table;
+    }();
+    static constexpr AdditionChain inversionChain = calculateAdditionChain(M - 1);
+    static_assert(inversionChain.values[inversionChain.length - 1] == M - 1, "Неправильний ланцюжок додавань");
+
+    // Реалізація множення обирається під час першого звернення за можливостями процесора.
+    // Атомарна, бо множення може виконуватися з кількох потоків одночасно.
+    static std::atomic<MultiplyBackend>& backend() {
+        static std::atomic<MultiplyBackend> selected{ cpuSupportsClmul() ? MultiplyBackend::PolynomialClmul : MultiplyBackend::Sparse };
+        return selected;
+    }
+
+    // z[0] = first, z[b] = first + x[0] + ... + x[b - 1]
+    static Limbs<M> prefixXor(const Limbs<M>& x, int first) {
+        Limbs<M> z;
+        uint64_t carry = first ? ~static_cast<uint64_t>(0) : 0;
+        for (int i = 0; i < words; ++i) {
+            // Включна префіксна сума всередині слова, далі зсув на 1 біт робить її виключною
+            uint64_t inclusive = x[i];
+            inclusive ^= inclusive << 1;
+            inclusive ^= inclusive << 2;
+            inclusive ^= inclusive << 4;
+            inclusive ^= inclusive << 8;
+            inclusive ^= inclusive << 16;
+            inclusive ^= inclusive << 32;
+            z[i] = (inclusive << 1) ^ carry;
+            // Старший біт включної суми - парність усього слова
+            carry ^= static_cast<uint64_t>(0) - (inclusive >> 63);
+        }
+        z[words - 1] &= topMask<M>;
+        return z;
+    }
+
+    bool testBit(int i) const {
+        return (value[i / 64] >> (i % 64)) & 1;
+    }
+
+    void setBit(int i) {
+        value[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+    }
 
 public:
-    GF2m() : value(0) {}
+    GF2m() : value{} {}
 
-    GF2m(const std::bitset<m>& val) : value(val) {}
+    GF2m(const Limbs<M>& val) : value(val) {
+        value[words - 1] &= topMask<M>;
+    }
+
+    GF2m(const std::bitset<M>& val) : value{} {
+        for (int i = 0; i < M; ++i) {
+            if (val.test(i)) setBit(i);
+        }
+    }
 
     GF2m(const std::string& str, bool isHex = 0) {
         *this = isHex ? fromHex(str) : fromString(str);
     }
 
-    static void calculateMultiplicativeMatrix() {
-        int p = 2 * m + 1;
+    // Одиниця нормального базису - сума всіх елементів базису
+    static GF2m one() {
+        Limbs<M> ones;
+        ones.fill(~static_cast<uint64_t>(0));
+        return GF2m(ones);
+    }
+
+    static Limbs<M> toPalindromic(const Limbs<M>& x) {
+        Limbs<M> r{};
+        for (int q = 0; q < nibbles; ++q) {
+            const Limbs<M>& entry = palindromicTables.to[q][(x[q / 16] >> (4 * (q % 16))) & 0xF];
+            for (int i = 0; i < words; ++i) r[i] ^= entry[i];
+        }
+        return r;
+    }
+
+    static Limbs<M> fromPalindromic(const Limbs<M>& x) {
+        Limbs<M> r{};
+        for (int q = 0; q < palindromicNibbles; ++q) {
+            const Limbs<M>& entry = palindromicTables.from[q][(x[q / 16] >> (4 * (q % 16))) & 0xF];
+            for (int i = 0; i < words; ++i) r[i] ^= entry[i];
+        }
+        return r;
+    }
+
+    // Згортка добутків D = A * B та F = A * rev(B) у палиндромне представлення:
+    // c_j = d_j + d_(p-j) + f_(M+j) + f_(M-j), j = 1..M
+    static Limbs<M> foldPalindromic(const WideLimbs<M>& d, const WideLimbs<M>& f) {
+        Limbs<M> direct = wideShiftRight<M>(f, M);
+        Limbs<M> mirrored = wideShiftRight<M>(d, M + 1);
+        for (int i = 0; i < words; ++i) {
+            direct[i] ^= d[i];
+            mirrored[i] ^= f[i];
+        }
+        mirrored[words - 1] &= topMask<M>;
+        Limbs<M> c = reverseHalf<M>(mirrored);
+        const uint64_t palindromicTopMask = ((M + 1) % 64) ? ((static_cast<uint64_t>(1) << ((M + 1) % 64)) - 1) : ~static_cast<uint64_t>(0);
+        direct[0] &= ~static_cast<uint64_t>(1);
+        direct[words - 1] &= palindromicTopMask;
+        for (int i = 0; i < words; ++i) c[i] ^= direct[i];
+        return c;
+    }
+
+    static constexpr const SparseMatrix<M>& getSparseMatrix() {
+        return sparseMatrix;
+    }
+
+    static MultiplyBackend getMultiplyBackend() {
+        return backend().load(std::memory_order_relaxed);
+    }
+
+    static void setMultiplyBackend(MultiplyBackend selected) {
+        if (selected == MultiplyBackend::PolynomialClmul && !cpuSupportsClmul()) {
+            throw std::runtime_error("Процесор не підтримує PCLMULQDQ");
+        }
+        backend().store(selected, std::memory_order_relaxed);
+    }
+
+    const Limbs<M>& limbs() const {
+        return value;
+    }
+
+    GF2m add(const GF2m& other) const {
+        GF2m result;
+        for (int i = 0; i < words; ++i) result.value[i] = value[i] ^ other.value[i];
+        return result;
+    }
+
+    // Циклічний зсув праворуч на k позицій, тобто піднесення до степеня 2^k.
+    // Від'ємне k відповідає добуванню кореня степеня 2^|k|.
+    GF2m rotate(int k) const {
+        k %= M;
+        if (k < 0) k += M;
+        if (k == 0) return *this;
+        Limbs<M> lo = shiftRight<M>(value, k);
+        Limbs<M> hi = shiftLeft<M>(value, M - k);
+        GF2m result;
+        for (int i = 0; i < words; ++i) result.value[i] = lo[i] | hi[i];
+        return result;
+    }
+
+    GF2m multiply(const GF2m& other) const {
+        GF2M_INSTRUMENT_OP(Multiply);
+        switch (backend().load(std::memory_order_relaxed)) {
+        case MultiplyBackend::PolynomialClmul:
+#ifdef GF2M_X86
+            return multiplyPolynomial(other, clmulLimbsHardware<words>);
+#else
+            [[fallthrough]];
+#endif
+        case MultiplyBackend::PolynomialScalar:
+            return multiplyPolynomial(other, clmulLimbsScalar<words>);
+        default:
+            return multiplySparse(other);
+        }
+    }
+
+    // Множення через палиндромне представлення, clmul - множення многочленів без переносів
+    template <typename Clmul>
+    GF2m multiplyPolynomial(const GF2m& other, Clmul clmul) const {
+        return GF2m(fromPalindromic(multiplyPalindromic(toPalindromic(value), toPalindromic(other.value), clmul)));
+    }
+
+    // Добуток двох елементів, що вже перебувають у палиндромному представленні
+    template <typename Clmul>
+    static Limbs<M> multiplyPalindromic(const Limbs<M>& a, const Limbs<M>& b, Clmul clmul) {
+        WideLimbs<M> d = clmul(a, b);
+        WideLimbs<M> f = clmul(a, reverseHalf<M>(b));
+        return foldPalindromic(d, f);
+    }
+
+    // Добуток послідовності множників. Для поліноміальних реалізацій добуток накопичується
+    // у палиндромному представленні: кожен множник перетворюється один раз, результат - наприкінці.
+    class Accumulator {
+        Limbs<M> acc{};
+        bool empty = true;
+        MultiplyBackend selected = getMultiplyBackend();
+
+    public:
+        void multiply(const GF2m& x) {
+            if (empty) {
+                acc = selected == MultiplyBackend::Sparse ? x.value : toPalindromic(x.value);
+                empty = false;
+                return;
+            }
+            GF2M_INSTRUMENT_OP(Multiply);
+            switch (selected) {
+            case MultiplyBackend::PolynomialClmul:
+#ifdef GF2M_X86
+                acc = multiplyPalindromic(acc, toPalindromic(x.value), clmulLimbsHardware<words>);
+                break;
+#else
+                [[fallthrough]];
+#endif
+            case MultiplyBackend::PolynomialScalar:
+                acc = multiplyPalindromic(acc, toPalindromic(x.value), clmulLimbsScalar<words>);
+                break;
+            default:
+                acc = GF2m(acc).multiplySparse(x).value;
+            }
+        }
+
+        // Порожній добуток дорівнює одиниці
+        GF2m result() const {
+            if (empty) return one();
+            return GF2m(selected == MultiplyBackend::Sparse ? acc : fromPalindromic(acc));
+        }
+    };
+
+    // Множення Мессі-Омури за розрідженою матрицею:
+    // z = A_o B_o + XOR по парах (A_j + A_k)(B_j + B_k), де o - непарний рядок, див. calculateSparseMatrix.
+    GF2m multiplySparse(const GF2m& other) const {
+        // rotA[j] = a.rotate(j + 1), rotB[j] = b.rotate(j + 1)
+        Limbs<M> rotA[M], rotB[M];
+        rotA[0] = rotateRightOne<M>(value);
+        rotB[0] = rotateRightOne<M>(other.value);
+        for (int j = 1; j < M; ++j) {
+            rotA[j] = rotateRightOne<M>(rotA[j - 1]);
+            rotB[j] = rotateRightOne<M>(rotB[j - 1]);
+        }
+        Limbs<M> z;
+        const int o = sparseMatrix.oddRow;
+        for (int i = 0; i < words; ++i) z[i] = rotA[o][i] & rotB[o][i];
+        for (const auto& [j, k] : sparseMatrix.pairs) {
+            for (int i = 0; i < words; ++i) {
+                z[i] ^= (rotA[j][i] ^ rotA[k][i]) & (rotB[j][i] ^ rotB[k][i]);
+            }
+        }
+        return GF2m(z);
+    }
+
+    // Еталонне множення безпосередньо за щільною multiplicativeMatrix
+    GF2m multiplyMatrix(const GF2m& other) const {
+        GF2m z;
+        for (int i = 0; i < M; ++i) {
+            GF2m u = rotate(M - i);
+            GF2m v = other.rotate(M - i);
+            // Множимо u на multiplicativeMatrix: XOR рядків, що відповідають одиничним бітам u
+            Limbs<M> u_times_matrix{};
+            for (int j = 0; j < M; ++j) {
+                if (u.testBit(j)) {
+                    for (int k = 0; k < words; ++k) u_times_matrix[k] ^= multiplicativeMatrix[j][k];
+                }
+            }
+            // Домножаємо на v: парність кількості спільних одиничних бітів
+            int parity = 0;
+            for (int k = 0; k < words; ++k) parity ^= std::popcount(u_times_matrix[k] & v.value[k]);
+            if (parity & 1)
+                z.setBit(M - i - 1);
+        }
+        return z;
+    }
+
+    GF2m square() const {
+        GF2M_INSTRUMENT_OP(Square);
+        return rotate(1);
+    }
+
+    GF2m pow(const GF2m& power) const {
+        return powSliding(power, powWindow);
+    }
+
+    // Піднесення до степеня бінарним методом справа наліво (еталон для powSliding)
+    GF2m powBinary(const GF2m& power) const {
+        GF2M_INSTRUMENT_OP(Pow);
+        GF2m result = one();
+        GF2m base = *this;
+
+        for (int i = 0; i < M; ++i) {
+            if (power.testBit(i)) {
+                result = result.multiply(base);
+            }
+            base = base.square();
+        }
+        return result;
+    }
+
+    // Ковзне вікно зліва направо. Оскільки a^(d * 2^j) = (a^d).rotate(j), квадрати безкоштовні:
+    // таблиця непарних степенів a^1, a^3, ..., a^(2^window - 1) коштує 2^(window-1) - 1 множень,
+    // а кожне вікно показника - одне множення.
+    GF2m powSliding(const GF2m& power, int window) const {
+        GF2M_INSTRUMENT_OP(Pow);
+        GF2m table[1 << (maxPowWindow - 1)];
+        oddPowers(window, table);
+        Accumulator product;
+        forEachWindow(power, window, [&](int digit, int j) { product.multiply(table[digit >> 1].rotate(j)); });
+        return product.result();
+    }
+
+    // table[d] = a^(2d + 1), d < 2^(window - 1)
+    void oddPowers(int window, GF2m* table) const {
+        if (window < 1 || window > maxPowWindow) {
+            throw std::invalid_argument("Ширина вікна має бути від 1 до " + std::to_string(maxPowWindow));
+        }
+        table[0] = *this;
+        if (window > 1) {
+            GF2m squared = square();
+            for (int d = 1; d < (1 << (window - 1)); ++d) table[d] = table[d - 1] * squared;
+        }
+    }
+
+    // Ковзні вікна показника від старших бітів: f(digit, j) для кожного вікна [j, i]
+    // з одиницями на обох кінцях, digit - непарне значення бітів i..j
+    template <typename F>
+    static void forEachWindow(const GF2m& power, int window, F f) {
+        for (int i = M - 1; i >= 0; --i) {
+            if (!power.testBit(i)) continue;
+            int j = std::max(i - window + 1, 0);
+            while (!power.testBit(j)) ++j;
+            int digit = 0;
+            for (int k = i; k >= j; --k) digit = (digit << 1) | power.testBit(k);
+            f(digit, j);
+            i = j;
+        }
+    }
+
+    // Добуток bases[i]^exponents[i] - лише зручна обгортка над powSliding та multiply.
+    // Метод Штрауса/Шаміра тут нічого не дає: він економить спільний ланцюжок піднесень до
+    // квадрату, а у нормальному базисі квадрати - безкоштовні зсуви, тож множень не менше, ніж в окремих pow.
+    static GF2m multiPow(std::span<const GF2m> bases, std::span<const GF2m> exponents, int window = powWindow) {
+        if (bases.size() != exponents.size()) {
+            throw std::invalid_argument("Кількість основ і показників має збігатися");
+        }
+        GF2m product = one();
+        for (size_t n = 0; n < bases.size(); ++n) product = product.multiply(bases[n].powSliding(exponents[n], window));
+        return product;
+    }
+
+    // Слід у нормальному базисі - парність кількості одиниць
+    int trace() const {
+        uint64_t acc = 0;
+        for (int i = 0; i < words; ++i) acc ^= value[i];
+        return std::popcount(acc) & 1;
+    }
+
+    // Квадратний корінь - циклічний зсув у протилежний бік
+    GF2m sqrt() const {
+        return rotate(-1);
+    }
+
+    // Розв'язок z^2 + z = c (c = *this), існує лише при trace(c) = 0; другий розв'язок z + 1.
+    // Оскільки z^2[b] = z[b + 1], маємо c[b] = z[b] + z[b + 1], тож при z[0] = 0
+    // z[b] = c[0] + ... + c[b - 1] - префіксна сума XOR, яку рахуємо по словах.
+    GF2m solveQuadratic() const {
+        if (trace() != 0) {
+            throw std::domain_error("Рівняння z^2 + z = c не має розв'язків при Tr(c) = 1");
+        }
+        return GF2m(prefixXor(value, 0));
+    }
+
+    // Напівслід для непарного M: H(c) = сума c^(2^(2i)), i = 0..(M-1)/2.
+    // H(c)^2 + H(c) = c + Tr(c), тож H(c) - один з двох розв'язків цього рівняння;
+    // потрібний визначаємо за бітом H(c)[0] = c[0] + c[2] + ... + c[M - 1].
+    GF2m halfTrace() const {
+        static_assert(M % 2 == 1, "Напівслід визначений лише для непарного M");
+        Limbs<M> c = value;
+        if (trace()) {
+            for (int i = 0; i < words; ++i) c[i] = ~c[i];
+            c[words - 1] &= topMask<M>;
+        }
+        uint64_t even = 0;
+        for (int i = 0; i < words; ++i) even ^= value[i] & 0x5555555555555555ULL;
+        return GF2m(prefixXor(c, std::popcount(even) & 1));
+    }
+
+    bool isZero() const {
+        uint64_t acc = 0;
+        for (int i = 0; i < words; ++i) acc |= value[i];
+        return acc == 0;
+    }
+
+    GF2m inverse() const {
+        if (isZero()) {
+            throw std::runtime_error("Неможливо знайти обернений елемент до нуля");
+        }
+        GF2M_INSTRUMENT_OP(Inverse);
+        // beta[k] = a^(2^u - 1), u = values[k]; beta_(u+v) = beta_u^(2^v) * beta_v
+        GF2m beta[inversionChain.length];
+        beta[0] = *this;
+        for (int k = 1; k < inversionChain.length; ++k) {
+            auto [i, j] = inversionChain.steps[k];
+            beta[k] = beta[i].rotate(inversionChain.values[j]) * beta[j];
+        }
+        // a^-1 = a^(2^M - 2) = (a^(2^(M-1) - 1))^2
+        return beta[inversionChain.length - 1].square();
+    }
+
+    static constexpr const AdditionChain& getInversionChain() {
+        return inversionChain;
+    }
+
+    // Одночасне обернення трюком Монтгомері: одне обернення та 3(N - 1) множень.
+    // Нульові елементи пропускаються і залишаються нулями.
+    static void batchInverse(std::span<GF2m> elements) {
+        GF2M_INSTRUMENT_OP(BatchInverse);
+        // prefix[i] - добуток ненульових елементів перед i
+        std::vector<GF2m> prefix(elements.size());
+        GF2m product;
+        size_t first = elements.size();
+        for (size_t i = 0; i < elements.size(); ++i) {
+            if (elements[i].isZero()) continue;
+            prefix[i] = product;
+            product = first == elements.size() ? elements[i] : product * elements[i];
+            if (first == elements.size()) first = i;
+        }
+        if (first == elements.size()) return;
+        // inv - обернений до добутку ненульових елементів з номерами <= i
+        GF2m inv = product.inverse();
+        for (size_t i = elements.size() - 1; i > first; --i) {
+            if (elements[i].isZero()) continue;
+            GF2m x = elements[i];
+            elements[i] = inv * prefix[i];
+            inv = inv * x;
+        }
+        elements[first] = inv;
+    }
+
+    std::string toString() const {
+        std::string str(M, '0');
+        for (int i = M - 1; i >= 0; --i) {
+            if (testBit(i)) str[M - 1 - i] = '1';
+        }
+        return str;
+    }
+
+    static GF2m fromString(const std::string& str) {
+        if (str.size() > M) {
+            throw std::invalid_argument("Рядок має неправильну довжину");
+        }
+        for (char c : str) {
+            if (c != '0' && c != '1') {
+                throw std::invalid_argument("Неправильний символ у рядку");
+            }
+        }
+        // Старший символ рядка відповідає біту з номером size-1
+        GF2m result;
+        int n = static_cast<int>(str.size());
+        for (int i = 0; i < n; ++i) {
+            if (str[n - 1 - i] == '1') result.setBit(i);
+        }
+        return result;
+    }
+
+    // Записує шістнадцяткове подання без лідуючих нулів у буфер на hexDigits символів, повертає довжину
+    size_t writeHex(char* out) const {
+        static const char alphabet[] = "0123456789ABCDEF";
+        int top = hexDigits - 1;
+        while (top > 0 && ((value[(4 * top) / 64] >> ((4 * top) % 64)) & 0xF) == 0) --top;
+        for (int d = top; d >= 0; --d) {
+            out[top - d] = alphabet[(value[(4 * d) / 64] >> ((4 * d) % 64)) & 0xF];
+        }
+        return static_cast<size_t>(top + 1);
+    }
+
+    std::string toHex() const {
+        char buffer[hexDigits];
+        return std::string(buffer, writeHex(buffer));
+    }
+
+    // Розбір шістнадцяткового запису [begin, end) безпосередньо у слова, без проміжних рядків.
+    // Лідуючі нулі дозволені, значущих біт має бути не більше M.
+    static GF2m parseHex(const char* begin, const char* end) {
+        GF2m result;
+        int d = 0;
+        for (const char* p = end; p != begin; ++d) {
+            int hexValue = hexDigitValues[static_cast<unsigned char>(*--p)];
+            if (hexValue < 0) {
+                throw std::invalid_argument("Неправильний символ у шістнадцятковому рядку");
+            }
+            if (hexValue == 0) continue;
+            // Цифра d займає біти 4d..4d+3
+            if (d >= hexDigits || (d == hexDigits - 1 && (hexValue >> (M - 4 * d)) != 0)) {
+                throw std::invalid_argument("Шістнадцятковий рядок занадто довгий");
+            }
+            result.value[(4 * d) / 64] |= static_cast<uint64_t>(hexValue) << ((4 * d) % 64);
+        }
+        return result;
+    }
+
+    static GF2m fromHex(const std::string& hexStr) {
+        return parseHex(hexStr.data(), hexStr.data() + hexStr.size());
+    }
+
+    // Компактний двійковий формат: binaryBytes байтів, старший байт першим
+    void writeBytes(uint8_t* out) const {
+        for (int i = 0; i < binaryBytes; ++i) {
+            int bit = 8 * (binaryBytes - 1 - i);
+            out[i] = static_cast<uint8_t>(value[bit / 64] >> (bit % 64));
+        }
+    }
+
+    static GF2m readBytes(const uint8_t* in) {
+        GF2m result;
+        for (int i = 0; i < binaryBytes; ++i) {
+            int bit = 8 * (binaryBytes - 1 - i);
+            result.value[bit / 64] |= static_cast<uint64_t>(in[i]) << (bit % 64);
+        }
+        if (in[0] >> (M - 8 * (binaryBytes - 1))) {
+            throw std::invalid_argument("Двійковий запис має більше ніж M значущих біт");
+        }
+        return result;
+    }
+
+    void print() const {
+        std::cout << toString() << std::endl;
+    }
+
+    bool operator==(const GF2m& other) const {
+        return value == other.value;
+    }
+
+    GF2m operator+(const GF2m& other) const {
+        return this->add(other);
+    }
+
+    // Суми добутків без проміжних зведень - через FusedSum, mulAdd або innerProduct
+    GF2m operator*(const GF2m& other) const {
+        return multiply(other);
+    }
+
+    GF2m& operator+=(const GF2m& other) {
+        for (int i = 0; i < words; ++i) value[i] ^= other.value[i];
+        return *this;
+    }
+
+    GF2m& operator*=(const GF2m& other) {
+        return *this = multiply(other);
+    }
+
+    // Сума добутків без проміжних зведень: для поліноміальних реалізацій добутки
+    // D = A * B та F = A * rev(B) накопичуються незведеними, а згортка та перетворення
+    // з палиндромного представлення виконуються один раз у result().
+    // Для Sparse злиття немає: множення Мессі-Омури одразу дає біти у нормальному базисі без
+    // окремого зведення, тож кожен доданок коштує повного multiplySparse.
+    class FusedSum {
+        WideLimbs<M> d{}, f{};
+        Limbs<M> normal{};
+        MultiplyBackend selected = getMultiplyBackend();
+
+        template <typename Clmul>
+        void accumulate(const GF2m& x, const GF2m& y, Clmul clmul) {
+            Limbs<M> a = toPalindromic(x.value), b = toPalindromic(y.value);
+            WideLimbs<M> dx = clmul(a, b), fx = clmul(a, reverseHalf<M>(b));
+            for (int i = 0; i < 2 * words; ++i) {
+                d[i] ^= dx[i];
+                f[i] ^= fx[i];
+            }
+        }
+
+    public:
+        void mulAdd(const GF2m& x, const GF2m& y) {
+            GF2M_INSTRUMENT_OP(Multiply);
+            switch (selected) {
+            case MultiplyBackend::PolynomialClmul:
+#ifdef GF2M_X86
+                accumulate(x, y, clmulLimbsHardware<words>);
+                break;
+#else
+                [[fallthrough]];
+#endif
+            case MultiplyBackend::PolynomialScalar:
+                accumulate(x, y, clmulLimbsScalar<words>);
+                break;
+            default: {
+                Limbs<M> z = x.multiplySparse(y).value;
+                for (int i = 0; i < words; ++i) normal[i] ^= z[i];
+            }
+            }
+        }
+
+        void add(const GF2m& x) {
+            for (int i = 0; i < words; ++i) normal[i] ^= x.value[i];
+        }
+
+        GF2m result() const {
+            if (selected == MultiplyBackend::Sparse) return GF2m(normal);
+            GF2m r(fromPalindromic(foldPalindromic(d, f)));
+            for (int i = 0; i < words; ++i) r.value[i] ^= normal[i];
+            return r;
+        }
+    };
+
+    // Скалярний добуток sum xs[i] * ys[i] з одним зведенням наприкінці
+    static GF2m innerProduct(std::span<const GF2m> xs, std::span<const GF2m> ys) {
+        if (xs.size() != ys.size()) {
+            throw std::invalid_argument("Вектори мають бути однакової довжини");
+        }
+        FusedSum sum;
+        for (size_t i = 0; i < xs.size(); ++i) sum.mulAdd(xs[i], ys[i]);
+        return sum.result();
+    }
+
+    static void printMultiplicativeMatrix() {
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < M; ++j) {
+                std::cout << ((multiplicativeMatrix[i][j / 64] >> (j % 64)) & 1);
+            }
+            std::cout << std::endl;
+        }
+    }
+};
+
+
+
+// acc += x * y
+template <int M>
+void mulAdd(GF2m<M>& acc, const GF2m<M>& x, const GF2m<M>& y) {
+    acc += x.multiply(y);
+}
+
+// Накопичення без проміжних зведень, результат - acc.result()
+template <int M>
+void mulAdd(typename GF2m<M>::FusedSum& acc, const GF2m<M>& x, const GF2m<M>& y) {
+    acc.mulAdd(x, y);
+}
+
+template <int M = m>
+GF2m<M> innerProduct(std::type_identity_t<std::span<const GF2m<M>>> xs, std::type_identity_t<std::span<const GF2m<M>>> ys) {
+    return GF2m<M>::innerProduct(xs, ys);
+}
+
+static_assert(std::is_trivially_copyable_v<GF2m<>>, "GF2m має копіюватися як звичайні дані");
+
+// Файл, відображений у пам'ять лише для читання (mmap / MapViewOfFile)
+class MappedFile {
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Не вдалося відкрити файл " + path);
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            throw std::runtime_error("Не вдалося визначити розмір файлу " + path);
+        }
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if (length == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!bytes) {
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Не вдалося відобразити файл " + path);
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Не вдалося відкрити файл " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Не вдалося визначити розмір файлу " + path);
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Не вдалося відобразити файл " + path);
+            }
+            bytes = static_cast<const char*>(address);
+        }
+        // Відображення залишається дійсним і після закриття дескриптора
+        close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (bytes) munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+
+    std::span<const char> data() const {
+        return { bytes, length };
+    }
+};
+
+// Атомарна заміна файлу: частини пишуться в тимчасовий файл з унікальним ім'ям поруч з path,
+// скидаються на диск і лише потім перейменовуються поверх path. Процеси, що пишуть той самий
+// path одночасно, не псують тимчасові файли один одного, а читачі бачать або старий, або
+// повний новий файл.
+inline void replaceFile(const std::string& path, std::initializer_list<std::span<const char>> parts) {
+    static std::atomic<uint64_t> counter{ 0 };
+#ifdef _WIN32
+    const uint64_t pid = GetCurrentProcessId();
+#else
+    const uint64_t pid = static_cast<uint64_t>(getpid());
+#endif
+    const std::string temporary = path + "." + std::to_string(pid) + "." + std::to_string(std::random_device{}()) + "."
+        + std::to_string(counter.fetch_add(1)) + ".tmp";
+    bool written = true;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(temporary.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Не вдалося створити тимчасовий файл для " + path);
+    }
+    for (std::span<const char> part : parts) {
+        for (size_t done = 0; written && done < part.size();) {
+            DWORD count = 0;
+            DWORD request = static_cast<DWORD>(std::min<size_t>(part.size() - done, 1u << 30));
+            written = WriteFile(file, part.data() + done, request, &count, nullptr) && count > 0;
+            done += count;
+        }
+    }
+    written = FlushFileBuffers(file) && written;
+    written = CloseHandle(file) && written;
+#else
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Не вдалося створити тимчасовий файл для " + path);
+    }
+    for (std::span<const char> part : parts) {
+        for (size_t done = 0; written && done < part.size();) {
+            ssize_t count = write(fd, part.data() + done, part.size() - done);
+            if (count < 0 && errno == EINTR) continue;
+            written = count > 0;
+            if (written) done += static_cast<size_t>(count);
+        }
+    }
+    written = fsync(fd) == 0 && written;
+    written = close(fd) == 0 && written;
+#endif
+    if (!written) {
+        std::error_code ignored;
+        std::filesystem::remove(temporary, ignored);
+        throw std::runtime_error("Не вдалося записати файл " + path);
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::error_code ignored;
+        std::filesystem::remove(temporary, ignored);
+        throw std::runtime_error("Не вдалося замінити файл " + path + ": " + error.message());
+    }
+#ifndef _WIN32
+    // Запис про перейменування в каталозі теж має потрапити на диск
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    int directoryFd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (directoryFd >= 0) {
+        fsync(directoryFd);
+        close(directoryFd);
+    }
+#endif
+}
+
+// Послідовне читання шістнадцяткових елементів з буфера (наприклад, MappedFile) без виділення пам'яті.
+// Роздільники - пробіли, табуляції, переноси рядків та коми.
+template <int M = m>
+class HexReader {
+    const char* position;
+    const char* end;
+
+    static bool isSeparator(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',';
+    }
+
+public:
+    explicit HexReader(std::span<const char> text) : position(text.data()), end(text.data() + text.size()) {}
+
+    // false, якщо елементів більше немає
+    bool next(GF2m<M>& out) {
+        while (position != end && isSeparator(*position)) ++position;
+        if (position == end) return false;
+        const char* begin = position;
+        while (position != end && !isSeparator(*position)) ++position;
+        out = GF2m<M>::parseHex(begin, position);
+        return true;
+    }
+};
+
+// Записи фіксованої довжини GF2m<M>::binaryBytes байтів, старший байт першим
+template <int M = m>
+class BinaryReader {
+    std::span<const char> bytes;
+
+public:
+    explicit BinaryReader(std::span<const char> bytes) : bytes(bytes) {
+        if (bytes.size() % GF2m<M>::binaryBytes != 0) {
+            throw std::invalid_argument("Розмір двійкових даних не кратний розміру елемента");
+        }
+    }
+
+    size_t size() const {
+        return bytes.size() / GF2m<M>::binaryBytes;
+    }
+
+    GF2m<M> operator[](size_t i) const {
+        return GF2m<M>::readBytes(reinterpret_cast<const uint8_t*>(bytes.data()) + i * GF2m<M>::binaryBytes);
+    }
+};
+
+// Запис шістнадцяткових елементів, по одному в рядку, у буфер викликача
+template <int M = m>
+class HexWriter {
+    std::span<char> buffer;
+    size_t length = 0;
+
+public:
+    explicit HexWriter(std::span<char> buffer) : buffer(buffer) {}
+
+    // false, якщо для елемента не вистачає місця; тоді буфер потрібно спорожнити (data, clear)
+    bool write(const GF2m<M>& x) {
+        if (buffer.size() - length < static_cast<size_t>(GF2m<M>::hexDigits) + 1) return false;
+        length += x.writeHex(buffer.data() + length);
+        buffer[length++] = '\n';
+        return true;
+    }
+
+    std::span<const char> data() const {
+        return buffer.first(length);
+    }
+
+    void clear() {
+        length = 0;
+    }
+};
+
+template <int M = m>
+class BinaryWriter {
+    std::span<char> buffer;
+    size_t length = 0;
+
+public:
+    explicit BinaryWriter(std::span<char> buffer) : buffer(buffer) {}
+
+    bool write(const GF2m<M>& x) {
+        if (buffer.size() - length < static_cast<size_t>(GF2m<M>::binaryBytes)) return false;
+        x.writeBytes(reinterpret_cast<uint8_t*>(buffer.data() + length));
+        length += GF2m<M>::binaryBytes;
+        return true;
+    }
+
+    std::span<const char> data() const {
+        return buffer.first(length);
+    }
+
+    void clear() {
+        length = 0;
+    }
+};
+
+// 64-бітна контрольна сума для файлів таблиць: по 8 байтів за крок з перемішуванням множенням,
+// залишок - побайтово (FNV-1a)
+inline uint64_t checksum64(const void* data, size_t bytes, uint64_t hash = 0xCBF29CE484222325ULL) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, p + i, 8);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+    for (; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// Заголовок файлу таблиці. Записи - слова елементів у порядку байтів машини, тому
+// endianTag перевіряє, що файл створено на машині з тим самим порядком байтів.
+struct TableFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t degree;
+    uint32_t teeth;
+    uint32_t entryBytes;
+    uint64_t entryCount;
+    uint64_t endianTag;
+    uint64_t checksum;
+};
+
+const char tableFileMagic[8] = { 'G', 'F', '2', 'M', 'T', 'B', 'L', '\0' };
+const uint32_t tableFileVersion = 1;
+const uint64_t tableFileEndianTag = 0x0102030405060708ULL;
+
+// Піднесення фіксованої основи g до різних степенів гребінцевим методом (Лім-Лі).
+// Показник ділиться на Teeth рядків по spacing біт; стовпець i збирає біти i, i + spacing, ...
+// у індекс d, а table[d] = добуток g^(2^(k * spacing)) по одиничних бітах k числа d.
+// Тоді g^e = добуток table[d_i]^(2^i), де піднесення до 2^i - циклічний зсув,
+// тож кожне обчислення коштує не більше spacing - 1 множень.
+template <int Teeth = 8, int M = m>
+class FixedBasePow {
+    static_assert(Teeth >= 1 && Teeth <= 16, "Кількість зубців гребінця має бути від 1 до 16");
+    static_assert(sizeof(GF2m<M>) == sizeof(Limbs<M>), "Записи файлу таблиці - слова елементів без доповнення");
+
+public:
+    static constexpr int spacing = (M + Teeth - 1) / Teeth;
+    static constexpr size_t entries = static_cast<size_t>(1) << Teeth;
+
+private:
+    // Таблиця або обчислена у процесі (owned), або відображена з файлу (mapped, тримає file)
+    std::vector<GF2m<M>> owned;
+    std::shared_ptr<const MappedFile> file;
+    const GF2m<M>* mapped = nullptr;
+
+    const GF2m<M>* table() const {
+        return mapped ? mapped : owned.data();
+    }
+
+    FixedBasePow() = default;
+
+public:
+    explicit FixedBasePow(const GF2m<M>& base) : owned(entries) {
+        owned[0] = GF2m<M>::one();
+        for (int k = 0; k < Teeth; ++k) {
+            GF2m<M> tooth = base.rotate(k * spacing);
+            owned[static_cast<size_t>(1) << k] = tooth;
+            for (size_t d = 1; d < (static_cast<size_t>(1) << k); ++d) {
+                owned[(static_cast<size_t>(1) << k) | d] = owned[d] * tooth;
+            }
+        }
+    }
+
+    const GF2m<M>& base() const {
+        return table()[1];
+    }
+
+    bool isMapped() const {
+        return mapped != nullptr;
+    }
+
+    GF2m<M> pow(const GF2m<M>& power) const {
+        GF2M_INSTRUMENT_OP(Pow);
+        const Limbs<M>& bits = power.limbs();
+        const GF2m<M>* entry = table();
+        typename GF2m<M>::Accumulator product;
+        for (int i = 0; i < spacing; ++i) {
+            size_t digit = 0;
+            for (int k = 0; k < Teeth; ++k) {
+                int bit = i + k * spacing;
+                if (bit < M) digit |= static_cast<size_t>((bits[bit / 64] >> (bit % 64)) & 1) << k;
+            }
+            if (digit != 0) product.multiply(entry[digit].rotate(i));
+        }
+        return product.result();
+    }
+
+    static TableFileHeader header() {
+        TableFileHeader h{};
+        std::copy(tableFileMagic, tableFileMagic + 8, h.magic);
+        h.version = tableFileVersion;
+        h.degree = M;
+        h.teeth = Teeth;
+        h.entryBytes = sizeof(GF2m<M>);
+        h.entryCount = entries;
+        h.endianTag = tableFileEndianTag;
+        return h;
+    }
+
+    // Контрольна сума заголовка (з нульовим полем checksum) та записів
+    static uint64_t checksum(TableFileHeader h, const GF2m<M>* table) {
+        h.checksum = 0;
+        return checksum64(table, entries * sizeof(GF2m<M>), checksum64(&h, sizeof(h)));
+    }
+
+    // Заміна через replaceFile: процеси, що вже відобразили старий файл, продовжують читати
+    // його сторінки, а не обрізаний файл (SIGBUS)
+    void save(const std::string& path) const {
+        TableFileHeader h = header();
+        h.checksum = checksum(h, table());
+        replaceFile(path, { std::span<const char>(reinterpret_cast<const char*>(&h), sizeof(h)),
+                            std::span<const char>(reinterpret_cast<const char*>(table()), entries * sizeof(GF2m<M>)) });
+    }
+
+    // Відображає таблицю з файлу без копіювання; сторінки файлу спільні для всіх процесів.
+    // Файл має відповідати M, Teeth, версії формату, контрольній сумі та основі base.
+    static FixedBasePow load(const std::string& path, const GF2m<M>& base) {
+        auto file = std::make_shared<const MappedFile>(path);
+        std::span<const char> data = file->data();
+        TableFileHeader h;
+        if (data.size() < sizeof(h)) {
+            throw std::runtime_error("Файл таблиці має неправильний розмір: " + path);
+        }
+        std::copy(data.begin(), data.begin() + sizeof(h), reinterpret_cast<char*>(&h));
+        // Таблиця іншої конфігурації (gen-tables --teeth або інше M) - окреме повідомлення
+        if (std::equal(tableFileMagic, tableFileMagic + 8, h.magic) && (h.teeth != Teeth || h.degree != M)) {
+            throw std::runtime_error("Файл таблиці " + path + " побудовано для m = " + std::to_string(h.degree) + ", " + std::to_string(h.teeth)
+                + " зубців; очікується m = " + std::to_string(M) + ", " + std::to_string(Teeth) + " зубців");
+        }
+        if (data.size() != sizeof(TableFileHeader) + entries * sizeof(GF2m<M>)) {
+            throw std::runtime_error("Файл таблиці має неправильний розмір: " + path);
+        }
+        TableFileHeader expected = header();
+        expected.checksum = h.checksum;
+        if (std::memcmp(&h, &expected, sizeof(h)) != 0) {
+            throw std::runtime_error("Файл таблиці створено для інших параметрів або версії: " + path);
+        }
+        // mmap вирівнює початок файлу на сторінку, а заголовок кратний 8 байтам
+        const GF2m<M>* table = reinterpret_cast<const GF2m<M>*>(data.data() + sizeof(TableFileHeader));
+        if (checksum(h, table) != h.checksum) {
+            throw std::runtime_error("Контрольна сума файлу таблиці не збігається: " + path);
+        }
+        if (!(table[1] == base)) {
+            throw std::runtime_error("Файл таблиці побудовано для іншої основи: " + path);
+        }
+        FixedBasePow result;
+        result.file = std::move(file);
+        result.mapped = table;
+        return result;
+    }
+
+    // Таблиця з файлу, а якщо його немає чи він непридатний - обчислена у процесі
+    static FixedBasePow loadOrCompute(const std::string& path, const GF2m<M>& base) {
+        try {
+            return load(path, base);
+        }
+        catch (const std::runtime_error&) {
+            return FixedBasePow(base);
+        }
+    }
+};
+
+// Множення на сталий множник c. Добуток x c лінійний за x над GF(2): це сума e_b c по одиничних
+// бітах x, де e_b - елемент з єдиним бітом b. Для кожної групи з Window біт x таблиця містить
+// суми для всіх 2^Window значень групи, тож множення - groups переглядів таблиці та XOR слів без
+// жодного зведення. Розмір таблиці groups * 2^Window елементів: для M = 173 це 44 * 16 (17 КБ)
+// при Window = 4 та 22 * 256 (135 КБ) при Window = 8. Адреси переглядів залежать від x,
+// тому час виконання не сталий щодо кешу.
+template <int Window = 4, int M = m>
+class FixedMultiplier {
+    static_assert(64 % Window == 0 && Window <= 8, "Ширина вікна має бути 1, 2, 4 або 8");
+
+public:
+    static constexpr int groups = (M + Window - 1) / Window;
+    static constexpr size_t entries = static_cast<size_t>(1) << Window;
+
+private:
+    GF2m<M> c;
+    // table[g * entries + v] - добуток c на елемент з бітами v у групі g
+    std::vector<Limbs<M>> table;
+
+public:
+    explicit FixedMultiplier(const GF2m<M>& operand) : c(operand), table(groups * entries) {
+        for (int g = 0; g < groups; ++g) {
+            Limbs<M>* row = table.data() + g * entries;
+            for (int k = 0; k < Window && g * Window + k < M; ++k) {
+                int b = g * Window + k;
+                Limbs<M> bit{};
+                bit[b / 64] = static_cast<uint64_t>(1) << (b % 64);
+                const size_t single = static_cast<size_t>(1) << k;
+                row[single] = GF2m<M>(bit).multiply(c).limbs();
+                for (size_t v = 1; v < single; ++v) {
+                    for (int w = 0; w < limbCount<M>; ++w) row[single | v][w] = row[single][w] ^ row[v][w];
+                }
+            }
+        }
+    }
+
+    const GF2m<M>& operand() const {
+        return c;
+    }
+
+    GF2m<M> multiply(const GF2m<M>& x) const {
+        GF2M_INSTRUMENT_OP(Multiply);
+        const Limbs<M>& bits = x.limbs();
+        const Limbs<M>* row = table.data();
+        Limbs<M> sum{};
+        for (int g = 0; g < groups; ++g, row += entries) {
+            size_t v = static_cast<size_t>(bits[(g * Window) / 64] >> ((g * Window) % 64)) & (entries - 1);
+            for (int w = 0; w < limbCount<M>; ++w) sum[w] ^= row[v][w];
+        }
+        return GF2m<M>(sum);
+    }
+
+    // out[i] = in[i] * c
+    void multiply(std::span<const GF2m<M>> in, std::span<GF2m<M>> out) const {
+        if (in.size() != out.size()) {
+            throw std::invalid_argument("Розміри вхідних і вихідних даних мають збігатися");
+        }
+        for (size_t i = 0; i < in.size(); ++i) out[i] = multiply(in[i]);
+    }
+};
+
+
+// Скаляр для множення точки: до M + 1 біт, слова від молодшого до старшого
+template <int M = m>
+using Scalar = std::array<uint64_t, limbCount<M + 1>>;
+
+// Точка кривої в афінних координатах
+template <int M = m>
+struct AffinePoint {
+    GF2m<M> x, y;
+    bool infinity = false;
+
+    bool operator==(const AffinePoint& other) const {
+        if (infinity || other.infinity) return infinity == other.infinity;
+        return x == other.x && y == other.y;
+    }
+};
+
+// Точка у проєктивних координатах Лопеса-Дахаба: x = X / Z, y = Y / Z^2, Z = 0 - нескінченність
+template <int M = m>
+struct LDPoint {
+    GF2m<M> X, Y, Z;
+
+    bool isInfinity() const {
+        return Z.isZero();
+    }
+};
+
+// Крива y^2 + xy = x^3 + a x^2 + b над GF(2^M), b != 0.
+// У проєктивних координатах додавання та подвоєння не потребують обернень,
+// а піднесення до квадрату у нормальному базисі - лише циклічний зсув.
+template <int M = m>
+class BinaryCurve {
+    GF2m<M> a, b;
+
+public:
+    BinaryCurve(const GF2m<M>& a, const GF2m<M>& b) : a(a), b(b) {
+        if (b.isZero()) {
+            throw std::invalid_argument("Крива з b = 0 вироджена");
+        }
+    }
+
+    // Крива з заданим a, що проходить через точку (x, y): b = y^2 + xy + x^3 + a x^2
+    static BinaryCurve throughPoint(const GF2m<M>& a, const AffinePoint<M>& point) {
+        GF2m<M> x2 = point.x.square();
+        return BinaryCurve(a, point.y.square() + point.x * point.y + x2 * point.x + a * x2);
+    }
+
+    const GF2m<M>& getA() const {
+        return a;
+    }
+
+    const GF2m<M>& getB() const {
+        return b;
+    }
+
+    bool isOnCurve(const AffinePoint<M>& point) const {
+        if (point.infinity) return true;
+        GF2m<M> x2 = point.x.square();
+        return point.y.square() + point.x * point.y == x2 * point.x + a * x2 + b;
+    }
+
+    // Стиснення точки: x та біт 0 елемента z = y / x (для P та -P ці біти різні, бо z і z + 1 відрізняються всіма бітами)
+    int compressionBit(const AffinePoint<M>& point) const {
+        if (point.infinity || point.x.isZero()) return 0;
+        return static_cast<int>(point.y.multiply(point.x.inverse()).limbs()[0] & 1);
+    }
+
+    // Відновлення точки за x: z = y / x задовольняє z^2 + z = x + a + b / x^2, а при x = 0 y = sqrt(b)
+    AffinePoint<M> decompress(const GF2m<M>& x, int bit) const {
+        if (x.isZero()) return { x, b.sqrt() };
+        GF2m<M> xInverse = x.inverse();
+        GF2m<M> z = (x + a + b * xInverse.square()).solveQuadratic();
+        if (static_cast<int>(z.limbs()[0] & 1) != bit) z = z + GF2m<M>::one();
+        return { x, x * z };
+    }
+
+    AffinePoint<M> negate(const AffinePoint<M>& point) const {
+        if (point.infinity) return point;
+        return { point.x, point.x + point.y };
+    }
+
+    // Афінне додавання з одним оберненням (еталон для проєктивних формул)
+    AffinePoint<M> addAffine(const AffinePoint<M>& p, const AffinePoint<M>& q) const {
+        if (p.infinity) return q;
+        if (q.infinity) return p;
+        GF2m<M> lambda;
+        if (p.x == q.x) {
+            if (!(p.y == q.y) || p.x.isZero()) return { GF2m<M>(), GF2m<M>(), true };
+            lambda = p.x + p.y * p.x.inverse();
+        }
+        else {
+            lambda = (p.y + q.y) * (p.x + q.x).inverse();
+        }
+        GF2m<M> x = lambda.square() + lambda + p.x + q.x + a;
+        GF2m<M> y = lambda * (p.x + x) + x + p.y;
+        return { x, y };
+    }
+
+    LDPoint<M> toProjective(const AffinePoint<M>& point) const {
+        if (point.infinity) return { GF2m<M>::one(), GF2m<M>(), GF2m<M>() };
+        return { point.x, point.y, GF2m<M>::one() };
+    }
+
+    AffinePoint<M> toAffine(const LDPoint<M>& point) const {
+        if (point.isInfinity()) return { GF2m<M>(), GF2m<M>(), true };
+        GF2m<M> zInverse = point.Z.inverse();
+        return { point.X * zInverse, point.Y * zInverse.square() };
+    }
+
+    // Перехід до афінних координат з одним спільним оберненням (GF2m::batchInverse)
+    std::vector<AffinePoint<M>> normalize(std::span<const LDPoint<M>> points) const {
+        std::vector<GF2m<M>> zInverse(points.size());
+        for (size_t i = 0; i < points.size(); ++i) zInverse[i] = points[i].Z;
+        GF2m<M>::batchInverse(zInverse);
+        std::vector<AffinePoint<M>> result(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (points[i].isInfinity()) {
+                result[i] = { GF2m<M>(), GF2m<M>(), true };
+                continue;
+            }
+            result[i] = { points[i].X * zInverse[i], points[i].Y * zInverse[i].square() };
+        }
+        return result;
+    }
+
+    // Подвоєння: Z3 = X1^2 Z1^2, X3 = X1^4 + b Z1^4, Y3 = b Z1^4 Z3 + X3 (a Z3 + Y1^2 + b Z1^4)
+    LDPoint<M> dbl(const LDPoint<M>& p) const {
+        if (p.isInfinity()) return p;
+        GF2m<M> x2 = p.X.square(), z2 = p.Z.square();
+        GF2m<M> bz4 = b * z2.square();
+        LDPoint<M> r;
+        r.Z = x2 * z2;
+        r.X = x2.square() + bz4;
+        r.Y = bz4 * r.Z + r.X * (a * r.Z + p.Y.square() + bz4);
+        return r;
+    }
+
+    // Змішане додавання проєктивної та афінної точок
+    LDPoint<M> addMixed(const LDPoint<M>& p, const AffinePoint<M>& q) const {
+        if (q.infinity) return p;
+        if (p.isInfinity()) return toProjective(q);
+        GF2m<M> z2 = p.Z.square();
+        GF2m<M> A = q.y * z2 + p.Y;
+        GF2m<M> B = q.x * p.Z + p.X;
+        if (B.isZero()) {
+            // Однакові x: або P = Q, або P = -Q
+            if (A.isZero()) return dbl(toProjective(q));
+            return { GF2m<M>::one(), GF2m<M>(), GF2m<M>() };
+        }
+        GF2m<M> C = p.Z * B;
+        GF2m<M> D = B.square() * (C + a * z2);
+        LDPoint<M> r;
+        r.Z = C.square();
+        GF2m<M> E = A * C;
+        r.X = A.square() + D + E;
+        GF2m<M> F = r.X + q.x * r.Z;
+        GF2m<M> G = (q.x + q.y) * r.Z.square();
+        r.Y = (E + r.Z) * F + G;
+        return r;
+    }
+
+    // Подвоєння та додавання зліва направо (еталон для драбини Монтгомері)
+    LDPoint<M> multiplyDoubleAdd(const Scalar<M>& k, const AffinePoint<M>& point) const {
+        LDPoint<M> r = toProjective({ GF2m<M>(), GF2m<M>(), true });
+        for (int i = M; i >= 0; --i) {
+            r = dbl(r);
+            if ((k[i / 64] >> (i % 64)) & 1) r = addMixed(r, point);
+        }
+        return r;
+    }
+
+    // Драбина Монтгомері лише за координатою x (Лопес, Дахаб): R0 = kP, R1 = (k + 1)P, R1 - R0 = P.
+    // Кожен біт - одне додавання та одне подвоєння, 6 множень незалежно від значення біта.
+    // Координата y відновлюється наприкінці без обернень, тож результат - проєктивна точка.
+    LDPoint<M> multiply(const Scalar<M>& k, const AffinePoint<M>& point) const {
+        if (point.infinity) return toProjective(point);
+        const GF2m<M>& x = point.x;
+        // Точка порядку 2 (x = 0) не підходить для формул драбини
+        if (x.isZero()) return multiplyDoubleAdd(k, point);
+
+        GF2m<M> X0 = GF2m<M>::one(), Z0, X1 = x, Z1 = GF2m<M>::one();
+        for (int i = M; i >= 0; --i) {
+            bool bit = (k[i / 64] >> (i % 64)) & 1;
+            GF2m<M>& Xa = bit ? X0 : X1;
+            GF2m<M>& Za = bit ? Z0 : Z1;
+            GF2m<M>& Xd = bit ? X1 : X0;
+            GF2m<M>& Zd = bit ? Z1 : Z0;
+            // Ra = R0 + R1: Z = (Xa Zd + Xd Za)^2, X = x Z + (Xa Zd)(Xd Za)
+            GF2m<M> u = Xa * Zd, v = Xd * Za;
+            Za = (u + v).square();
+            Xa = x * Za + u * v;
+            // Rd = 2 Rd: X = Xd^4 + b Zd^4, Z = Xd^2 Zd^2
+            GF2m<M> xd2 = Xd.square(), zd2 = Zd.square();
+            Zd = xd2 * zd2;
+            Xd = xd2.square() + b * zd2.square();
+        }
+        if (Z0.isZero()) return toProjective({ GF2m<M>(), GF2m<M>(), true });
+        if (Z1.isZero()) return toProjective(negate(point));
+        // x3 = X0 / Z0, y3 = (x + x3) N / (x Z0 Z1) + y, N = (X0 + x Z0)(X1 + x Z1) + (x^2 + y) Z0 Z1.
+        // У координатах Лопеса-Дахаба зі знаменником Z = x Z0 Z1 це не потребує обернень.
+        GF2m<M> z0z1 = Z0 * Z1;
+        GF2m<M> t = X0 + x * Z0;
+        GF2m<M> n = t * (X1 + x * Z1) + (x.square() + point.y) * z0z1;
+        LDPoint<M> r;
+        r.Z = x * z0z1;
+        GF2m<M> xz1 = x * Z1;
+        r.X = X0 * xz1;
+        r.Y = t * n * xz1 + point.y * r.Z.square();
+        return r;
+    }
+
+    // Множення багатьох точок з одним спільним оберненням наприкінці
+    std::vector<AffinePoint<M>> multiplyBatch(std::span<const Scalar<M>> scalars, std::span<const AffinePoint<M>> points) const {
+        if (scalars.size() != points.size()) {
+            throw std::invalid_argument("Кількість скалярів і точок має збігатися");
+        }
+        std::vector<LDPoint<M>> projective(points.size());
+        for (size_t i = 0; i < points.size(); ++i) projective[i] = multiply(scalars[i], points[i]);
+        return normalize(projective);
+    }
+};
+
+
+bool cpuSupportsAvx2() {
+#ifdef GF2M_MULTIVERSION
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool cpuSupportsAvx512() {
+#ifdef GF2M_MULTIVERSION
+    return __builtin_cpu_supports("avx512f");
+#else
+    return false;
+#endif
+}
+
+// Транспонування бітової матриці 64x64: біт c слова r переходить у біт r слова c
+inline void transpose64(uint64_t a[64]) {
+    uint64_t mask = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        for (int k = 0; k < 64; k = (k + j + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k + j]) & mask;
+            a[k] ^= t << j;
+            a[k + j] ^= t;
+        }
+    }
+}
+
+// Ядро множення пакетів за розрідженою матрицею (див. calculateSparseMatrix).
+// a, b містять по 2M рядків, рядок r - логічний біт (r + 1) mod M, тож A_j для біта t
+// добутку лежить у рядку t + j. Кожен рядок - W слів, які компілятор векторизує.
+template <int M, int W>
+GF2M_ALWAYS_INLINE void batchMultiplyKernel(const uint64_t (*a)[W], const uint64_t (*b)[W], uint64_t (*z)[W]) {
+    constexpr const SparseMatrix<M>& matrix = GF2m<M>::getSparseMatrix();
+    for (int t = 0; t < M; ++t) {
+        uint64_t acc[W];
+        const uint64_t* x = a[t + matrix.oddRow];
+        const uint64_t* y = b[t + matrix.oddRow];
+        for (int w = 0; w < W; ++w) acc[w] = x[w] & y[w];
+        for (int n = 0; n < M - 1; ++n) {
+            const uint64_t* xj = a[t + matrix.pairs[n].first];
+            const uint64_t* xk = a[t + matrix.pairs[n].second];
+            const uint64_t* yj = b[t + matrix.pairs[n].first];
+            const uint64_t* yk = b[t + matrix.pairs[n].second];
+            for (int w = 0; w < W; ++w) acc[w] ^= (xj[w] ^ xk[w]) & (yj[w] ^ yk[w]);
+        }
+        for (int w = 0; w < W; ++w) z[t][w] = acc[w];
+    }
+}
+
+template <int M, int W>
+void batchMultiplyGeneric(const uint64_t (*a)[W], const uint64_t (*b)[W], uint64_t (*z)[W]) {
+    batchMultiplyKernel<M, W>(a, b, z);
+}
+
+#ifdef GF2M_MULTIVERSION
+template <int M, int W>
+GF2M_TARGET_AVX2 void batchMultiplyAvx2(const uint64_t (*a)[W], const uint64_t (*b)[W], uint64_t (*z)[W]) {
+    batchMultiplyKernel<M, W>(a, b, z);
+}
+
+template <int M, int W>
+GF2M_TARGET_AVX512 void batchMultiplyAvx512(const uint64_t (*a)[W], const uint64_t (*b)[W], uint64_t (*z)[W]) {
+    batchMultiplyKernel<M, W>(a, b, z);
+}
+#endif
+
+template <int M, int W>
+void batchMultiply(const uint64_t (*a)[W], const uint64_t (*b)[W], uint64_t (*z)[W]) {
+#ifdef GF2M_MULTIVERSION
+    static const bool avx512 = cpuSupportsAvx512();
+    static const bool avx2 = cpuSupportsAvx2();
+    if (W % 8 == 0 && avx512) return batchMultiplyAvx512<M, W>(a, b, z);
+    if (W % 4 == 0 && avx2) return batchMultiplyAvx2<M, W>(a, b, z);
+#endif
+    batchMultiplyGeneric<M, W>(a, b, z);
+}
+
+// Пакет з 64 * W незалежних елементів поля у транспонованому (bitsliced) вигляді:
+// рядок r містить біт r усіх елементів, по одному в кожній з 64 * W доріжок.
+// Піднесення до квадрату у нормальному базисі - циклічний зсув, тому воно лише змінює offset.
+template <int W, int M = m>
+class GF2mBatch {
+public:
+    static constexpr int lanes = 64 * W;
+    static constexpr int words = limbCount<M>;
+
+private:
+    // Логічний біт i зберігається у рядку (i + offset) mod M, 0 <= offset < M
+    alignas(64) uint64_t rows[M][W];
+    int offset;
+
+    const uint64_t* row(int i) const {
+        return rows[(i + offset) % M];
+    }
+
+    // 2M рядків, де рядок r містить логічний біт (r + 1) mod M (вхід batchMultiplyKernel)
+    void unrotate(uint64_t (*out)[W]) const {
+        for (int r = 0; r < 2 * M; ++r) {
+            const uint64_t* src = row((r + 1) % M);
+            for (int w = 0; w < W; ++w) out[r][w] = src[w];
+        }
+    }
+
+public:
+    GF2mBatch() : rows{}, offset(0) {}
+
+    // Усі доріжки містять x
+    static GF2mBatch broadcast(const GF2m<M>& x) {
+        GF2mBatch result;
+        for (int i = 0; i < M; ++i) {
+            uint64_t fill = ((x.limbs()[i / 64] >> (i % 64)) & 1) ? ~static_cast<uint64_t>(0) : 0;
+            for (int w = 0; w < W; ++w) result.rows[i][w] = fill;
+        }
+        return result;
+    }
+
+    // Доріжки, що лишилися без елементів, заповнюються нулями
+    static GF2mBatch load(std::span<const GF2m<M>> elements) {
+        if (elements.size() > static_cast<size_t>(lanes)) {
+            throw std::invalid_argument("Забагато елементів для пакета");
+        }
+        GF2mBatch result;
+        uint64_t block[64];
+        for (int w = 0; w < W; ++w) {
+            for (int i = 0; i < words; ++i) {
+                for (int r = 0; r < 64; ++r) {
+                    size_t lane = static_cast<size_t>(64 * w + r);
+                    block[r] = lane < elements.size() ? elements[lane].limbs()[i] : 0;
+                }
+                transpose64(block);
+                for (int c = 0; c < 64 && 64 * i + c < M; ++c) result.rows[64 * i + c][w] = block[c];
+            }
+        }
+        return result;
+    }
+
+    // Записує перші min(out.size(), lanes) доріжок
+    void store(std::span<GF2m<M>> out) const {
+        size_t count = std::min(out.size(), static_cast<size_t>(lanes));
+        std::vector<Limbs<M>> limbs(count);
+        uint64_t block[64];
+        for (int w = 0; w < W; ++w) {
+            for (int i = 0; i < words; ++i) {
+                for (int c = 0; c < 64; ++c) block[c] = 64 * i + c < M ? row(64 * i + c)[w] : 0;
+                transpose64(block);
+                for (int r = 0; r < 64; ++r) {
+                    size_t lane = static_cast<size_t>(64 * w + r);
+                    if (lane < count) limbs[lane][i] = block[r];
+                }
+            }
+        }
+        for (size_t lane = 0; lane < count; ++lane) out[lane] = GF2m<M>(limbs[lane]);
+    }
+
+    GF2m<M> get(int lane) const {
+        Limbs<M> value{};
+        for (int i = 0; i < M; ++i) {
+            value[i / 64] |= ((row(i)[lane / 64] >> (lane % 64)) & 1) << (i % 64);
+        }
+        return GF2m<M>(value);
+    }
+
+    void set(int lane, const GF2m<M>& x) {
+        uint64_t bit = static_cast<uint64_t>(1) << (lane % 64);
+        for (int i = 0; i < M; ++i) {
+            uint64_t& word = rows[(i + offset) % M][lane / 64];
+            word = ((x.limbs()[i / 64] >> (i % 64)) & 1) ? (word | bit) : (word & ~bit);
+        }
+    }
+
+    GF2mBatch add(const GF2mBatch& other) const {
+        GF2mBatch result;
+        for (int i = 0; i < M; ++i) {
+            const uint64_t* x = row(i);
+            const uint64_t* y = other.row(i);
+            for (int w = 0; w < W; ++w) result.rows[i][w] = x[w] ^ y[w];
+        }
+        return result;
+    }
+
+    GF2mBatch multiply(const GF2mBatch& other) const {
+        GF2M_INSTRUMENT_OP(LanesMultiply);
+        alignas(64) uint64_t a[2 * M][W];
+        alignas(64) uint64_t b[2 * M][W];
+        unrotate(a);
+        other.unrotate(b);
+        GF2mBatch result;
+        batchMultiply<M, W>(a, b, result.rows);
+        return result;
+    }
+
+    // a^(2^k) для всіх доріжок: лише зміна offset
+    GF2mBatch rotate(int k) const {
+        GF2mBatch result = *this;
+        k %= M;
+        if (k < 0) k += M;
+        result.offset = (offset + k) % M;
+        return result;
+    }
+
+    GF2mBatch square() const {
+        return rotate(1);
+    }
+
+    // Спільний показник для всіх доріжок: a^e = добуток a^(2^i) по одиничних бітах e
+    GF2mBatch pow(const GF2m<M>& power) const {
+        GF2M_INSTRUMENT_OP(LanesPow);
+        GF2mBatch result = broadcast(GF2m<M>::one());
+        for (int i = 0; i < M; ++i) {
+            if ((power.limbs()[i / 64] >> (i % 64)) & 1) {
+                result = result.multiply(rotate(i));
+            }
+        }
+        return result;
+    }
+
+    // Власний показник у кожній доріжці. Одиниця нормального базису - усі біти 1,
+    // тому множник a^(2^i) або 1 обирається як a^(2^i) | ~e_i без розгалужень.
+    GF2mBatch pow(const GF2mBatch& powers) const {
+        GF2M_INSTRUMENT_OP(LanesPow);
+        GF2mBatch result = broadcast(GF2m<M>::one());
+        for (int i = 0; i < M; ++i) {
+            const uint64_t* mask = powers.row(i);
+            GF2mBatch factor = rotate(i);
+            for (int r = 0; r < M; ++r) {
+                for (int w = 0; w < W; ++w) factor.rows[r][w] |= ~mask[w];
+            }
+            result = result.multiply(factor);
+        }
+        return result;
+    }
+
+    // Алгоритм Іто-Цудзії за тим самим ланцюжком, що й GF2m::inverse; нульові доріжки залишаються нулями
+    GF2mBatch inverse() const {
+        GF2M_INSTRUMENT_OP(LanesInverse);
+        constexpr const AdditionChain& chain = GF2m<M>::getInversionChain();
+        std::vector<GF2mBatch> beta(chain.length);
+        beta[0] = *this;
+        for (int k = 1; k < chain.length; ++k) {
+            auto [i, j] = chain.steps[k];
+            beta[k] = beta[i].rotate(chain.values[j]).multiply(beta[j]);
+        }
+        return beta[chain.length - 1].square();
+    }
+
+    bool operator==(const GF2mBatch& other) const {
+        for (int i = 0; i < M; ++i) {
+            for (int w = 0; w < W; ++w) {
+                if (row(i)[w] != other.row(i)[w]) return false;
+            }
+        }
+        return true;
+    }
+
+    GF2mBatch operator+(const GF2mBatch& other) const {
+        return add(other);
+    }
+
+    GF2mBatch operator*(const GF2mBatch& other) const {
+        return multiply(other);
+    }
+};
+
+// Многочлен над GF(2^M): coefficients[i] - коефіцієнт при x^i, старший коефіцієнт ненульовий.
+// Множення - Карацуба, ділення - ітерації Ньютона для оберненого ряду, обчислення в багатьох
+// точках та інтерполяція - через дерево добутків (subproduct tree).
+template <int M = m>
+class GF2mPoly {
+    std::vector<GF2m<M>> c;
+
+    void trim() {
+        while (!c.empty() && c.back().isZero()) c.pop_back();
+    }
+
+    // out[0..n+k-2] += a * b, кожен коефіцієнт - одна сума добутків з одним зведенням
+    static void multiplySchoolbook(const GF2m<M>* a, size_t n, const GF2m<M>* b, size_t k, GF2m<M>* out) {
+        for (size_t i = 0; i + 1 < n + k; ++i) {
+            typename GF2m<M>::FusedSum sum;
+            size_t from = i + 1 > k ? i + 1 - k : 0, to = std::min(i, n - 1);
+            for (size_t j = from; j <= to; ++j) sum.mulAdd(a[j], b[i - j]);
+            out[i] += sum.result();
+        }
+    }
+
+    // out[0..n+k-2] += a * b. У характеристиці 2 середній доданок Карацуби
+    // (a0 + a1)(b0 + b1) + a0 b0 + a1 b1 не потребує віднімань.
+    static void multiplyKaratsuba(const GF2m<M>* a, size_t n, const GF2m<M>* b, size_t k, GF2m<M>* out) {
+        if (n == 0 || k == 0) return;
+        if (std::min(n, k) < karatsubaThreshold) {
+            multiplySchoolbook(a, n, b, k, out);
+            return;
+        }
+        size_t h = (std::max(n, k) + 1) / 2;
+        // Один з множників коротший за половину: ділимо лише довший
+        if (k <= h) {
+            multiplyKaratsuba(a, h, b, k, out);
+            multiplyKaratsuba(a + h, n - h, b, k, out + h);
+            return;
+        }
+        if (n <= h) {
+            multiplyKaratsuba(a, n, b, h, out);
+            multiplyKaratsuba(a, n, b + h, k - h, out + h);
+            return;
+        }
+        std::vector<GF2m<M>> low(2 * h - 1), high(n + k - 2 * h - 1), middle(2 * h - 1), sa(a, a + h), sb(b, b + h);
+        for (size_t i = h; i < n; ++i) sa[i - h] += a[i];
+        for (size_t i = h; i < k; ++i) sb[i - h] += b[i];
+        multiplyKaratsuba(a, h, b, h, low.data());
+        multiplyKaratsuba(a + h, n - h, b + h, k - h, high.data());
+        multiplyKaratsuba(sa.data(), h, sb.data(), h, middle.data());
+        for (size_t i = 0; i < low.size(); ++i) middle[i] += low[i];
+        for (size_t i = 0; i < high.size(); ++i) middle[i] += high[i];
+        for (size_t i = 0; i < low.size(); ++i) out[i] += low[i];
+        for (size_t i = 0; i < middle.size(); ++i) out[i + h] += middle[i];
+        for (size_t i = 0; i < high.size(); ++i) out[i + 2 * h] += high[i];
+    }
+
+    // Перші count коефіцієнтів (многочлен за модулем x^count)
+    GF2mPoly truncated(size_t count) const {
+        return GF2mPoly(std::vector<GF2m<M>>(c.begin(), c.begin() + std::min(count, c.size())));
+    }
+
+    // Обернений ряд: g * (*this) = 1 mod x^count. У характеристиці 2 крок Ньютона
+    // g <- 2g - f g^2 перетворюється на g <- f g^2, а g^2 - лише квадрати коефіцієнтів (зсуви).
+    GF2mPoly inverseSeries(size_t count) const {
+        GF2mPoly g(std::vector<GF2m<M>>{ c[0].inverse() });
+        for (size_t k = 1; k < count;) {
+            k = std::min(2 * k, count);
+            std::vector<GF2m<M>> squared(2 * g.c.size() - 1);
+            for (size_t i = 0; i < g.c.size(); ++i) squared[2 * i] = g.c[i].square();
+            g = (truncated(k) * GF2mPoly(std::move(squared))).truncated(k);
+        }
+        return g;
+    }
+
+    // Ділення стовпчиком: (n - d + 1)(d + 1) множень
+    std::pair<GF2mPoly, GF2mPoly> divideLong(const GF2mPoly& divisor) const {
+        const int n = degree(), d = divisor.degree();
+        std::vector<GF2m<M>> q(n - d + 1), r(c);
+        GF2m<M> lead = divisor.c[d];
+        bool monic = lead == GF2m<M>::one();
+        GF2m<M> leadInverse = monic ? lead : lead.inverse();
+        for (int i = n; i >= d; --i) {
+            if (r[i].isZero()) continue;
+            GF2m<M> factor = monic ? r[i] : r[i].multiply(leadInverse);
+            q[i - d] = factor;
+            for (int j = 0; j <= d; ++j) r[i - d + j] += factor * divisor.c[j];
+        }
+        r.resize(d);
+        return { GF2mPoly(std::move(q)), GF2mPoly(std::move(r)) };
+    }
+
+public:
+    // Розміри, з яких вигідні Карацуба та ділення через обернений ряд
+    static constexpr size_t karatsubaThreshold = 16;
+    static constexpr int newtonThreshold = 64;
+
+    GF2mPoly() = default;
+
+    explicit GF2mPoly(std::vector<GF2m<M>> coefficients) : c(std::move(coefficients)) {
+        trim();
+    }
+
+    // x - root (у характеристиці 2 це x + root)
+    static GF2mPoly linear(const GF2m<M>& root) {
+        return GF2mPoly(std::vector<GF2m<M>>{ root, GF2m<M>::one() });
+    }
+
+    // Степінь нульового многочлена -1
+    int degree() const {
+        return static_cast<int>(c.size()) - 1;
+    }
+
+    bool isZero() const {
+        return c.empty();
+    }
+
+    const std::vector<GF2m<M>>& coefficients() const {
+        return c;
+    }
+
+    GF2m<M> coefficient(size_t i) const {
+        return i < c.size() ? c[i] : GF2m<M>();
+    }
+
+    bool operator==(const GF2mPoly& other) const {
+        return c == other.c;
+    }
+
+    GF2mPoly operator+(const GF2mPoly& other) const {
+        std::vector<GF2m<M>> r(std::max(c.size(), other.c.size()));
+        for (size_t i = 0; i < c.size(); ++i) r[i] = c[i];
+        for (size_t i = 0; i < other.c.size(); ++i) r[i] += other.c[i];
+        return GF2mPoly(std::move(r));
+    }
+
+    GF2mPoly operator*(const GF2mPoly& other) const {
+        if (isZero() || other.isZero()) return {};
+        std::vector<GF2m<M>> r(c.size() + other.c.size() - 1);
+        multiplyKaratsuba(c.data(), c.size(), other.c.data(), other.c.size(), r.data());
+        return GF2mPoly(std::move(r));
+    }
+
+    // Множення без Карацуби (еталон)
+    GF2mPoly multiplyNaive(const GF2mPoly& other) const {
+        if (isZero() || other.isZero()) return {};
+        std::vector<GF2m<M>> r(c.size() + other.c.size() - 1);
+        multiplySchoolbook(c.data(), c.size(), other.c.data(), other.c.size(), r.data());
+        return GF2mPoly(std::move(r));
+    }
+
+    // Похідна: у характеристиці 2 залишаються лише коефіцієнти при непарних степенях
+    GF2mPoly derivative() const {
+        std::vector<GF2m<M>> r(c.empty() ? 0 : c.size() - 1);
+        for (size_t i = 1; i < c.size(); i += 2) r[i - 1] = c[i];
+        return GF2mPoly(std::move(r));
+    }
+
+    // Ділення з остачею: *this = q * divisor + r, deg r < deg divisor
+    std::pair<GF2mPoly, GF2mPoly> divide(const GF2mPoly& divisor) const {
+        if (divisor.isZero()) {
+            throw std::invalid_argument("Ділення на нульовий многочлен");
+        }
+        const int n = degree(), d = divisor.degree();
+        if (n < d) return { GF2mPoly(), *this };
+        if (n - d < newtonThreshold || d < newtonThreshold / 4) return divideLong(divisor);
+        // rev(q) = rev(a) * rev(b)^-1 mod x^(n - d + 1), rev - коефіцієнти у зворотному порядку
+        const size_t count = static_cast<size_t>(n - d + 1);
+        std::vector<GF2m<M>> reversedA(count), reversedB(divisor.c.rbegin(), divisor.c.rend());
+        for (size_t i = 0; i < count; ++i) reversedA[i] = c[n - i];
+        GF2mPoly reversedQ = (GF2mPoly(std::move(reversedA)) * GF2mPoly(std::move(reversedB)).inverseSeries(count)).truncated(count);
+        std::vector<GF2m<M>> q(count);
+        for (size_t i = 0; i < count; ++i) q[i] = reversedQ.coefficient(count - 1 - i);
+        GF2mPoly quotient(std::move(q));
+        return { quotient, *this + quotient * divisor };
+    }
+
+    GF2mPoly operator%(const GF2mPoly& divisor) const {
+        return divide(divisor).second;
+    }
+
+    // Схема Горнера в одній точці
+    GF2m<M> evaluate(const GF2m<M>& x) const {
+        GF2m<M> result;
+        for (size_t i = c.size(); i-- > 0;) result = result.multiply(x) + c[i];
+        return result;
+    }
+
+    // Горнер одночасно для 64 * W точок у GF2mBatch: одне пакетне множення на коефіцієнт
+    template <int W = 8>
+    std::vector<GF2m<M>> evaluateHorner(std::span<const GF2m<M>> points) const {
+        std::vector<GF2m<M>> result(points.size());
+        const size_t lanes = GF2mBatch<W, M>::lanes;
+        for (size_t begin = 0; begin < points.size(); begin += lanes) {
+            size_t count = std::min(lanes, points.size() - begin);
+            auto x = GF2mBatch<W, M>::load(points.subspan(begin, count));
+            GF2mBatch<W, M> acc;
+            for (size_t i = c.size(); i-- > 0;) {
+                acc = acc * x + GF2mBatch<W, M>::broadcast(c[i]);
+            }
+            acc.store(std::span<GF2m<M>>(result).subspan(begin, count));
+        }
+        return result;
+    }
+
+    // Дерево добутків: levels[0][i] = x - points[i], вузол - добуток двох дочірніх,
+    // непарний останній вузол переходить на рівень вище без змін
+    static std::vector<std::vector<GF2mPoly>> subproductTree(std::span<const GF2m<M>> points) {
+        std::vector<std::vector<GF2mPoly>> levels(1);
+        for (const GF2m<M>& x : points) levels[0].push_back(linear(x));
+        while (levels.back().size() > 1) {
+            const std::vector<GF2mPoly>& below = levels.back();
+            std::vector<GF2mPoly> above;
+            for (size_t i = 0; i + 1 < below.size(); i += 2) above.push_back(below[i] * below[i + 1]);
+            if (below.size() % 2) above.push_back(below.back());
+            levels.push_back(std::move(above));
+        }
+        return levels;
+    }
+
+    // Значення в точках листків дерева: остачі від ділення спускаються від кореня до листків
+    std::vector<GF2m<M>> evaluateTree(const std::vector<std::vector<GF2mPoly>>& tree) const {
+        std::vector<GF2mPoly> remainders{ *this % tree.back()[0] };
+        for (size_t level = tree.size() - 1; level-- > 0;) {
+            std::vector<GF2mPoly> next(tree[level].size());
+            for (size_t i = 0; i < next.size(); ++i) next[i] = remainders[i / 2] % tree[level][i];
+            remainders = std::move(next);
+        }
+        std::vector<GF2m<M>> values(remainders.size());
+        for (size_t i = 0; i < values.size(); ++i) values[i] = remainders[i].coefficient(0);
+        return values;
+    }
+
+    std::vector<GF2m<M>> evaluateTree(std::span<const GF2m<M>> points) const {
+        if (points.empty()) return {};
+        return evaluateTree(subproductTree(points));
+    }
+
+    // Інтерполяція Лагранжа: f = sum y_i w_i P(x) / (x - x_i), P = prod (x - x_i), w_i = 1 / P'(x_i).
+    // Ваги обертаються одним GF2m::batchInverse, суми збираються знизу вгору по дереву.
+    static GF2mPoly interpolate(std::span<const GF2m<M>> xs, std::span<const GF2m<M>> ys) {
+        if (xs.size() != ys.size()) {
+            throw std::invalid_argument("Кількість точок і значень має збігатися");
+        }
+        if (xs.empty()) return {};
+        auto tree = subproductTree(xs);
+        std::vector<GF2m<M>> weights = tree.back()[0].derivative().evaluateTree(tree);
+        for (const GF2m<M>& w : weights) {
+            if (w.isZero()) {
+                throw std::invalid_argument("Точки інтерполяції мають бути різними");
+            }
+        }
+        GF2m<M>::batchInverse(weights);
+        std::vector<GF2mPoly> sums(xs.size());
+        for (size_t i = 0; i < xs.size(); ++i) sums[i] = GF2mPoly(std::vector<GF2m<M>>{ ys[i] * weights[i] });
+        for (size_t level = 0; level + 1 < tree.size(); ++level) {
+            std::vector<GF2mPoly> above;
+            for (size_t i = 0; i + 1 < sums.size(); i += 2) {
+                above.push_back(sums[i] * tree[level][i + 1] + sums[i + 1] * tree[level][i]);
+            }
+            if (sums.size() % 2) above.push_back(sums.back());
+            sums = std::move(above);
+        }
+        return sums[0];
+    }
+};
+
+
+// Пул потоків з крадіжкою задач: кожен потік бере задачі з кінця своєї черги,
+// а коли вона порожня - з початку черг інших потоків.
+class ThreadPool {
+    struct Queue {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<size_t> queued{ 0 };
+    std::atomic<size_t> nextQueue{ 0 };
+    bool stopping = false;
+
+    // Пул і номер черги поточного потоку, якщо він є робочим потоком пулу
+    inline static thread_local ThreadPool* currentPool = nullptr;
+    inline static thread_local size_t currentIndex = 0;
+
+    bool tryRun(size_t self) {
+        for (size_t k = 0; k < queues.size(); ++k) {
+            Queue& queue = *queues[(self + k) % queues.size()];
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> guard(queue.lock);
+                if (queue.tasks.empty()) continue;
+                if (k == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+            }
+            queued.fetch_sub(1);
+            task();
+            return true;
+        }
+        return false;
+    }
+
+    // Виконує задачі з черг, поки remaining не стане 0; коли черги порожні - спить на wake
+    void waitFor(const std::atomic<size_t>& remaining, size_t self) {
+        while (remaining.load() > 0) {
+            if (tryRun(self)) continue;
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [&] { return remaining.load() == 0 || queued.load() > 0; });
+        }
+    }
+
+    void workerLoop(size_t index) {
+        currentPool = this;
+        currentIndex = index;
+        while (true) {
+            if (tryRun(index)) continue;
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [this] { return stopping || queued.load() > 0; });
+            if (stopping && queued.load() == 0) return;
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threadCount = std::max<size_t>(1, std::thread::hardware_concurrency())) {
+        if (threadCount == 0) {
+            throw std::invalid_argument("Пул потоків має містити хоча б один потік");
+        }
+        for (size_t i = 0; i < threadCount; ++i) queues.push_back(std::make_unique<Queue>());
+        for (size_t i = 0; i < threadCount; ++i) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    // Спільний пул на всі апаратні потоки
+    static ThreadPool& global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    size_t size() const {
+        return workers.size();
+    }
+
+    void submit(std::function<void()> task) {
+        size_t index = currentPool == this ? currentIndex : nextQueue.fetch_add(1) % queues.size();
+        {
+            std::lock_guard<std::mutex> guard(queues[index]->lock);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            queued.fetch_add(1);
+        }
+        wake.notify_one();
+    }
+
+    // body(chunk, begin, end) для частин [0, count) розміром chunk; викликаючий потік допомагає
+    // виконувати задачі до завершення всіх частин, а коли черги порожні - спить на wake до появи
+    // нових задач або завершення останньої частини. Перший виняток з частин перекидається далі.
+    // Якщо submit кине виняток (bad_alloc), вже поставлені частини завершуються до виходу.
+    template <typename Body>
+    void parallelFor(size_t count, size_t chunk, Body&& body) {
+        if (count == 0) return;
+        chunk = std::max<size_t>(chunk, 1);
+        size_t chunks = (count + chunk - 1) / chunk;
+        std::atomic<size_t> remaining{ chunks };
+        std::mutex errorLock;
+        std::exception_ptr error;
+#ifdef GF2M_INSTRUMENT
+        Instrumentation::Scope* scope = Instrumentation::Scope::current();
+#endif
+        auto task = [&](size_t c) {
+            return [&, c] {
+                {
+                    // Лічильники задачі зливаються у фазу до того, як викликач дізнається про завершення
+#ifdef GF2M_INSTRUMENT
+                    Instrumentation::Scope::Bind bind(scope);
+#endif
+                    try {
+                        body(c, c * chunk, std::min(count, (c + 1) * chunk));
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> guard(errorLock);
+                        if (!error) error = std::current_exception();
+                    }
+                }
+                if (remaining.fetch_sub(1) == 1) {
+                    // Через sleepLock, щоб викликач не пропустив сигнал між перевіркою та очікуванням
+                    { std::lock_guard<std::mutex> guard(sleepLock); }
+                    wake.notify_all();
+                }
+            };
+        };
+        size_t self = currentPool == this ? currentIndex : 0;
+        size_t submitted = 0;
+        try {
+            for (; submitted < chunks; ++submitted) submit(task(submitted));
+        }
+        catch (...) {
+            // Частини, що вже в черзі, посилаються на цей кадр стека: дочекатися їх перед розкручуванням
+            remaining.fetch_sub(chunks - submitted);
+            waitFor(remaining, self);
+            throw;
+        }
+        waitFor(remaining, self);
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+// Розмір частини для паралельної обробки: дані частини (bytesPerItem на елемент) мають
+// вміщатися в половину L2 (~256 КБ), і на кожен потік має припадати хоча б 8 частин для балансування
+inline size_t parallelChunkSize(size_t count, size_t bytesPerItem, size_t threads) {
+    const size_t cacheBytes = 256 * 1024;
+    size_t byCache = std::max<size_t>(1, cacheBytes / std::max<size_t>(1, bytesPerItem));
+    size_t byBalance = std::max<size_t>(1, count / (8 * threads));
+    return std::min(byCache, byBalance);
+}
+
+// output[i] = f(input[i]); результат не залежить від кількості потоків
+template <typename Input, typename Output, typename F>
+void parallel_map(const Input& input, Output&& output, F f, ThreadPool& pool = ThreadPool::global()) {
+    if (input.size() != output.size()) {
+        throw std::invalid_argument("Розміри вхідних і вихідних даних мають збігатися");
+    }
+    GF2M_INSTRUMENT_OP(Parallel);
+    size_t chunk = parallelChunkSize(input.size(), sizeof(input[0]) + sizeof(output[0]), pool.size());
+    pool.parallelFor(input.size(), chunk, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) output[i] = f(input[i]);
+    });
+}
+
+// Згортка асоціативною операцією op: часткові результати частин об'єднуються по порядку,
+// тож результат детермінований навіть для некомутативних op
+template <typename T, typename Input, typename Op>
+T parallel_reduce(const Input& input, const T& identity, Op op, ThreadPool& pool = ThreadPool::global()) {
+    GF2M_INSTRUMENT_OP(Parallel);
+    size_t chunk = parallelChunkSize(input.size(), sizeof(input[0]), pool.size());
+    std::vector<T> partial((input.size() + chunk - 1) / chunk, identity);
+    pool.parallelFor(input.size(), chunk, [&](size_t c, size_t begin, size_t end) {
+        T acc = input[begin];
+        for (size_t i = begin + 1; i < end; ++i) acc = op(acc, input[i]);
+        partial[c] = acc;
+    });
+    T result = identity;
+    for (const T& value : partial) result = op(result, value);
+    return result;
+}
+
+template <int M = m>
+void parallel_pow(std::type_identity_t<std::span<const GF2m<M>>> input, const GF2m<M>& power, std::type_identity_t<std::span<GF2m<M>>> output, ThreadPool& pool = ThreadPool::global()) {
+    parallel_map(input, output, [&](const GF2m<M>& x) { return x.pow(power); }, pool);
+}
+
+// Кожна частина обертається трюком Монтгомері (GF2m::batchInverse): одне обернення на частину.
+// Нульові елементи, як і в batchInverse, залишаються нулями.
+template <int M = m>
+void parallel_inverse(std::type_identity_t<std::span<const GF2m<M>>> input, std::type_identity_t<std::span<GF2m<M>>> output, ThreadPool& pool = ThreadPool::global()) {
+    if (input.size() != output.size()) {
+        throw std::invalid_argument("Розміри вхідних і вихідних даних мають збігатися");
+    }
+    GF2M_INSTRUMENT_OP(Parallel);
+    size_t chunk = parallelChunkSize(input.size(), 3 * sizeof(GF2m<M>), pool.size());
+    pool.parallelFor(input.size(), chunk, [&](size_t, size_t begin, size_t end) {
+        std::copy(input.begin() + begin, input.begin() + end, output.begin() + begin);
+        GF2m<M>::batchInverse(output.subspan(begin, end - begin));
+    });
+}
+
+template <int M = m>
+GF2m<M> parallel_product(std::type_identity_t<std::span<const GF2m<M>>> input, ThreadPool& pool = ThreadPool::global()) {
+    return parallel_reduce(input, GF2m<M>::one(), [](const GF2m<M>& x, const GF2m<M>& y) { return x * y; }, pool);
+}
+
+// Сума (XOR) усіх елементів
+template <int M = m>
+GF2m<M> parallel_sum(std::type_identity_t<std::span<const GF2m<M>>> input, ThreadPool& pool = ThreadPool::global()) {
+    return parallel_reduce(input, GF2m<M>(), [](const GF2m<M>& x, const GF2m<M>& y) { return x + y; }, pool);
+}
+
+
+// Пакетне обчислення запитів (режим eval). Рядковий формат: "<операція> <операнди в hex>",
+// порожні рядки пропускаються; відповідь - рядок з результатом або "error: <повідомлення>".
+// Двійковий формат: байт коду операції (порядок як у evalOperationNames) та два операнди по
+// GF2m::binaryBytes байтів (другий ігнорується для унарних); відповідь - байт стану (0 - успіх)
+// та результат. Слід повертається як елемент зі значенням 0 або 1 у молодшому біті.
+enum class EvalOperation : uint8_t { Add, Multiply, Square, Sqrt, Inverse, Pow, Trace, Count };
+
+const char* const evalOperationNames[] = { "add", "mul", "sqr", "sqrt", "inv", "pow", "trace" };
+
+struct EvalRequest {
+    EvalOperation op = EvalOperation::Add;
+    GF2m<> x, y, result;
+    // Непорожнє, якщо запит не вдалося розібрати або обчислити
+    std::string error;
+};
+
+inline int evalOperandCount(EvalOperation op) {
+    return op == EvalOperation::Add || op == EvalOperation::Multiply || op == EvalOperation::Pow ? 2 : 1;
+}
+
+// Читання запитів порціями: у пам'яті лише поточна порція, незалежно від розміру вводу
+class EvalReader {
+    std::istream& in;
+    bool binary;
+
+    static constexpr size_t recordBytes = 1 + 2 * GF2m<>::binaryBytes;
+
+    // false - кінець вводу
+    bool readLine(EvalRequest& request) {
+        std::string line;
+        do {
+            if (!std::getline(in, line)) return false;
+        } while (line.find_first_not_of(" \t\r") == std::string::npos);
+        std::istringstream tokens(line);
+        std::string name, operands[3];
+        tokens >> name >> operands[0] >> operands[1] >> operands[2];
+        auto it = std::find(std::begin(evalOperationNames), std::end(evalOperationNames), name);
+        if (it == std::end(evalOperationNames)) {
+            request.error = "невідома операція " + name;
+            return true;
+        }
+        request.op = static_cast<EvalOperation>(it - std::begin(evalOperationNames));
+        int count = evalOperandCount(request.op);
+        if (operands[count - 1].empty() || !operands[count].empty()) {
+            request.error = name + " очікує операндів: " + std::to_string(count);
+            return true;
+        }
+        try {
+            request.x = GF2m<>::fromHex(operands[0]);
+            if (count == 2) request.y = GF2m<>::fromHex(operands[1]);
+        }
+        catch (const std::invalid_argument& e) {
+            request.error = e.what();
+        }
+        return true;
+    }
+
+    bool readRecord(EvalRequest& request) {
+        uint8_t record[recordBytes];
+        in.read(reinterpret_cast<char*>(record), recordBytes);
+        if (in.gcount() == 0) return false;
+        if (in.gcount() != static_cast<std::streamsize>(recordBytes)) {
+            request.error = "Неповний двійковий запис";
+            return true;
+        }
+        if (record[0] >= static_cast<uint8_t>(EvalOperation::Count)) {
+            request.error = "невідомий код операції " + std::to_string(record[0]);
+            return true;
+        }
+        request.op = static_cast<EvalOperation>(record[0]);
+        try {
+            request.x = GF2m<>::readBytes(record + 1);
+            if (evalOperandCount(request.op) == 2) request.y = GF2m<>::readBytes(record + 1 + GF2m<>::binaryBytes);
+        }
+        catch (const std::invalid_argument& e) {
+            request.error = e.what();
+        }
+        return true;
+    }
+
+public:
+    EvalReader(std::istream& in, bool binary) : in(in), binary(binary) {}
+
+    // До count запитів; менше - ввід закінчився
+    std::vector<EvalRequest> read(size_t count) {
+        std::vector<EvalRequest> batch;
+        EvalRequest request;
+        while (batch.size() < count && (binary ? readRecord(request) : readLine(request))) {
+            batch.push_back(std::move(request));
+            request = EvalRequest();
+        }
+        return batch;
+    }
+};
+
+// Множення йдуть у бітсрізові пакети GF2mBatch<8> по 512 доріжок (короткий залишок - скалярно), обернення - трюком
+// Монтгомері по частинах, решта операцій - поелементно; усі три групи - на пулі потоків.
+inline void evaluateBatch(std::vector<EvalRequest>& batch, ThreadPool& pool = ThreadPool::global()) {
+    std::vector<size_t> multiplies, inverses, others;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (!batch[i].error.empty()) continue;
+        if (batch[i].op == EvalOperation::Multiply) multiplies.push_back(i);
+        else if (batch[i].op != EvalOperation::Inverse) others.push_back(i);
+        else if (batch[i].x.isZero()) batch[i].error = "Неможливо знайти обернений елемент до нуля";
+        else inverses.push_back(i);
+    }
+
+    using Batch = GF2mBatch<8>;
+    pool.parallelFor(multiplies.size(), Batch::lanes, [&](size_t, size_t begin, size_t end) {
+        // Пакет коштує стільки ж, скільки повний, тож для кількох множень вигідніше скалярне
+        if (end - begin < Batch::lanes / 4) {
+            for (size_t i = begin; i < end; ++i) batch[multiplies[i]].result = batch[multiplies[i]].x.multiply(batch[multiplies[i]].y);
+            return;
+        }
+        std::vector<GF2m<>> xs(end - begin), ys(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            xs[i - begin] = batch[multiplies[i]].x;
+            ys[i - begin] = batch[multiplies[i]].y;
+        }
+        (Batch::load(xs) * Batch::load(ys)).store(xs);
+        for (size_t i = begin; i < end; ++i) batch[multiplies[i]].result = xs[i - begin];
+    });
 
-        for (int i = 0; i < m; ++i) {
-            for (int j = 0; j < m; ++j) {
-                int two_i = mod_pow2(i, p);
-                int two_j = mod_pow2(j, p);
+    size_t chunk = parallelChunkSize(inverses.size(), 3 * sizeof(GF2m<>), pool.size());
+    pool.parallelFor(inverses.size(), chunk, [&](size_t, size_t begin, size_t end) {
+        std::vector<GF2m<>> xs(end - begin);
+        for (size_t i = begin; i < end; ++i) xs[i - begin] = batch[inverses[i]].x;
+        GF2m<>::batchInverse(xs);
+        for (size_t i = begin; i < end; ++i) batch[inverses[i]].result = xs[i - begin];
+    });
 
-                if ((two_i + two_j) % p == 1 ||
-                    (two_i - two_j + p) % p == 1 ||
-                    ((p - two_i) + two_j) % p == 1 ||
-                    ((p - two_i) - two_j + p) % p == 1) {
-                    multiplicativeMatrix[m - i - 1][m - j - 1] = 1;
-                }
+    chunk = parallelChunkSize(others.size(), sizeof(EvalRequest), pool.size());
+    pool.parallelFor(others.size(), chunk, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            EvalRequest& r = batch[others[i]];
+            switch (r.op) {
+            case EvalOperation::Add: r.result = r.x + r.y; break;
+            case EvalOperation::Square: r.result = r.x.square(); break;
+            case EvalOperation::Sqrt: r.result = r.x.sqrt(); break;
+            case EvalOperation::Pow: r.result = r.x.pow(r.y); break;
+            default: {
+                Limbs<m> bit{};
+                bit[0] = static_cast<uint64_t>(r.x.trace());
+                r.result = GF2m<>(bit);
+            }
             }
         }
-    }
+    });
+}
 
-    GF2m add(const GF2m& other) const {
-        return GF2m(value ^ other.value);
-    }
+// Читає запити порціями по batchSize, поки пул обчислює попередню порцію, та пише відповіді
+// в порядку запитів. Одночасно в пам'яті не більше двох порцій. Повертає кількість помилок.
+inline size_t evaluateStream(std::istream& in, std::ostream& out, bool binary, size_t batchSize, ThreadPool& pool = ThreadPool::global()) {
+    EvalReader reader(in, binary);
+    batchSize = std::max<size_t>(batchSize, 1);
+    size_t errors = 0;
+    std::string buffer;
+    // Читання йде в іншому потоці, тож прив'язаний потік (std::cin -> std::cout) не можна
+    // скидати з нього: це було б одночасне звернення до буфера, в який пише цей потік
+    std::ostream* tied = in.tie(nullptr);
+    auto next = std::async(std::launch::async, [&] { return reader.read(batchSize); });
+    for (;;) {
+        std::vector<EvalRequest> batch = next.get();
+        if (batch.empty()) break;
+        if (batch.size() == batchSize) next = std::async(std::launch::async, [&] { return reader.read(batchSize); });
+        evaluateBatch(batch, pool);
 
-    GF2m multiply(const GF2m& other) const {
-        std::bitset<m> z;
-        for (int i = 0; i < m; ++i) {
-            std::bitset<m> u = (value << i) | (value >> (m - i));
-            std::bitset<m> v = (other.value << i) | (other.value >> (m - i));
-            std::bitset<m> u_times_matrix;
-            // Множимо u на multiplicativeMatrix
-            for (int j = 0; j < m; ++j) {
-                if (u.test(j)) {
-                    for (int k = 0; k < m; ++k) {
-                        if (multiplicativeMatrix[j].test(k)) {
-                            u_times_matrix.flip(k);
-                        }
-                    }
-                }
+        buffer.clear();
+        for (const EvalRequest& r : batch) {
+            errors += !r.error.empty();
+            if (binary) {
+                char record[1 + GF2m<>::binaryBytes] = {};
+                record[0] = r.error.empty() ? 0 : 1;
+                if (r.error.empty()) r.result.writeBytes(reinterpret_cast<uint8_t*>(record + 1));
+                buffer.append(record, sizeof(record));
             }
-            // Домножаємо на v
-            for (int j = 0; j < m; ++j) {
-                if (u_times_matrix.test(j) && v.test(j))
-                    z.flip(m - i - 1);
+            else if (!r.error.empty()) {
+                buffer += "error: " + r.error + "\n";
+            }
+            else {
+                char text[GF2m<>::hexDigits];
+                buffer.append(text, r.result.writeHex(text));
+                buffer += '\n';
             }
         }
-        return GF2m(z);
-    }
-
-    GF2m square() const {
-        return GF2m((value >> 1) | (value << (m - 1)));
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.flush();
+        if (batch.size() < batchSize) break;
     }
+    in.tie(tied);
+    return errors;
+}
 
-    GF2m pow(const GF2m& power) const {
-        GF2m result("1FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", 1);
-        GF2m base = *this;
 
-        for (int i = 0; i < m; ++i) {
-            if (power.value.test(i)) {
-                result = result.multiply(base);
-            }
-            base = base.square();
-        }
-        return result;
+// Випадкові елементи з фіксованим зерном для тестів та вимірювань
+template <int M = m>
+std::vector<GF2m<M>> randomElements(size_t count, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<GF2m<M>> result(count);
+    for (auto& x : result) {
+        Limbs<M> limbs;
+        for (auto& word : limbs) word = gen();
+        x = GF2m<M>(limbs);
     }
+    return result;
+}
 
-    int trace() const {
-        return value.count()%2;
+// Незалежний еталон для перевірок: множення початкової версії на std::bitset<M> з матрицею,
+// обчисленою під час виконання. Не використовує слова, rotate, testBit та constexpr-таблиці GF2m,
+// тож помилка у спільному коді реалізацій GF2m не сховається від порівняння. Дуже повільний.
+template <int M = m>
+struct BitsetReference {
+    static const std::vector<std::bitset<M>>& multiplicativeMatrix() {
+        static const std::vector<std::bitset<M>> matrix = [] {
+            std::vector<std::bitset<M>> rows(M);
+            const int p = 2 * M + 1;
+            auto modPow2 = [p](int exponent) {
+                int result = 1;
+                for (int i = 0; i < exponent; ++i) result = (result << 1) % p;
+                return result;
+            };
+            for (int i = 0; i < M; ++i) {
+                for (int j = 0; j < M; ++j) {
+                    int two_i = modPow2(i), two_j = modPow2(j);
+                    if ((two_i + two_j) % p == 1 ||
+                        (two_i - two_j + p) % p == 1 ||
+                        ((p - two_i) + two_j) % p == 1 ||
+                        ((p - two_i) - two_j + p) % p == 1) {
+                        rows[M - i - 1][M - j - 1] = 1;
+                    }
+                }
+            }
+            return rows;
+        }();
+        return matrix;
     }
 
-    GF2m inverse() const {
-        if (this->value.none()) {
-            throw std::runtime_error("Неможливо знайти обернений елемент до нуля");
-        }
-        int t = 31 - custom_clz(m - 1);
-        GF2m a = *this;
-        GF2m b = a;
-        GF2m tmp;
-        int k = 1;
-        for (int i = t - 1; i >= 0; --i) {
-            tmp = b;
-            for (int j = 0; j < k; j++) b = b.square();
-            b = b * tmp;
-            k = 2 * k;
-            if ((m-1) & (1 << i)) {
-                b = b.square() * a;
-                k = k + 1;
-            }
-        }
-        b = b.square();
-        return b;
+    static std::bitset<M> toBitset(const GF2m<M>& x) {
+        std::bitset<M> bits;
+        for (int i = 0; i < M; ++i) bits[i] = (x.limbs()[i / 64] >> (i % 64)) & 1;
+        return bits;
     }
 
-    std::string toString() const {
-        std::string str;
-        for (int i = m - 1; i >= 0; --i) {
-            str += (value.test(i) ? '1' : '0');
-        }
-        return str;
+    static GF2m<M> fromBitset(const std::bitset<M>& bits) {
+        Limbs<M> limbs{};
+        for (int i = 0; i < M; ++i) limbs[i / 64] |= static_cast<uint64_t>(bits[i]) << (i % 64);
+        return GF2m<M>(limbs);
     }
 
-    static GF2m fromString(const std::string& str) {
-        std::string result = str;
-        if (str.size() > m) {
-            throw std::invalid_argument("Рядок має неправильну довжину");
-        }
-        if (str.size() < m) {
-            // Доповнюємо рядок нулями зліва
-            result = std::string(m - str.size(), '0') + str;
-        }
-        for (char c : str) {
-            if (c != '0' && c != '1') {
-                throw std::invalid_argument("Неправильний символ у рядку");
+    static GF2m<M> multiply(const GF2m<M>& a, const GF2m<M>& b) {
+        const std::bitset<M> x = toBitset(a), y = toBitset(b);
+        std::bitset<M> z;
+        for (int i = 0; i < M; ++i) {
+            std::bitset<M> u = (x << i) | (x >> (M - i));
+            std::bitset<M> v = (y << i) | (y >> (M - i));
+            // Множимо u на матрицю, потім скалярно на v
+            std::bitset<M> uTimesMatrix;
+            for (int j = 0; j < M; ++j) {
+                if (u.test(j)) uTimesMatrix ^= multiplicativeMatrix()[j];
             }
+            if ((uTimesMatrix & v).count() % 2) z.flip(M - i - 1);
         }
-        return GF2m(std::bitset<m>(result));
+        return fromBitset(z);
     }
 
-    std::string toHex() const {
-        std::string hexStr;
-
-        for (int i = 0; i < m; i += 4) {
-            int hexValue = 0;
-            for (int j = 0; j < 4 && (i + j) < m; ++j) {
-                if (value.test(i + j)) {
-                    hexValue |= 1 << j;
-                }
-            }
+    static GF2m<M> square(const GF2m<M>& a) {
+        const std::bitset<M> x = toBitset(a);
+        return fromBitset((x >> 1) | (x << (M - 1)));
+    }
+};
 
-            char hexChar = hexValue < 10 ? '0' + hexValue : 'A' + hexValue - 10;
-            hexStr = hexChar + hexStr;
-        }
+// Звіт перевірки: лічильники та перші maxMessages описів розбіжностей для відтворення
+struct ValidationReport {
+    static constexpr size_t maxMessages = 20;
+    std::atomic<uint64_t> checks{ 0 }, failures{ 0 };
+    std::mutex mutex;
+    std::vector<std::string> messages;
 
-        // Видалення лідуючих нулів
-        size_t startPos = hexStr.find_first_not_of('0');
-        if (startPos != std::string::npos) {
-            hexStr = hexStr.substr(startPos);
-        }
-        else {
-            hexStr = "0"; // Всі біти були нулями
+    // Не assert: перевірки мають працювати і зі збіркою NDEBUG
+    void check(bool ok, const char* name, uint64_t chunkSeed, size_t iteration, const GF2m<>& a, const GF2m<>& b) {
+        checks.fetch_add(1, std::memory_order_relaxed);
+        if (ok) return;
+        failures.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (messages.size() < maxMessages) {
+            messages.push_back(std::string(name) + ": зерно частини " + std::to_string(chunkSeed) + ", ітерація " + std::to_string(iteration)
+                + ", a = " + a.toHex() + ", b = " + b.toHex());
         }
+    }
+};
 
-        return hexStr;
+// Частина перевірки: chunkSize випадкових трійок з зерна chunkSeed. Прямі виклики ядер множення
+// (розріджене, поліноміальне, PCLMUL, бітсрізові пакети, таблиці FixedMultiplier) порівнюються з
+// multiplyMatrix, а сам multiplyMatrix та square - з незалежним BitsetReference (граничні
+// значення та кожна 16-та трійка, бо еталон повільний). Пакетні inverse та pow, а також
+// FixedBasePow з пам'яті та з файлу порівнюються з inverse та powBinary. Операції, що залежать
+// від вибраного способу множення (pow, inverse, Accumulator, FusedSum, parallel_pow,
+// parallel_inverse, множення точки кривої), перевіряються алгебраїчними тотожностями.
+inline void validateChunk(uint64_t chunkSeed, size_t chunkSize, bool kernels, ValidationReport& report, ThreadPool& pool) {
+    std::vector<GF2m<>> xs = randomElements(chunkSize, chunkSeed), ys = randomElements(chunkSize, ~chunkSeed), zs = randomElements(chunkSize, chunkSeed ^ 0x5A5A5A5A5A5A5A5AULL);
+    // Граничні значення: нуль, одиниця, елементи з одним бітом
+    if (chunkSize >= 4) {
+        xs[0] = GF2m<>();
+        xs[1] = GF2m<>::one();
+        ys[2] = GF2m<>();
+        Limbs<m> bit{};
+        bit[(chunkSeed % m) / 64] = static_cast<uint64_t>(1) << ((chunkSeed % m) % 64);
+        xs[3] = GF2m<>(bit);
     }
+    auto check = [&](bool ok, const char* name, size_t i) { report.check(ok, name, chunkSeed, i, xs[i], ys[i]); };
 
-    static GF2m fromHex(const std::string& hexStr) {
-        std::string binStr;
-        for (char hexChar : hexStr) {
-            int hexValue;
-            if (hexChar >= '0' && hexChar <= '9') {
-                hexValue = hexChar - '0';
+    if (kernels) {
+        std::vector<GF2m<>> reference(chunkSize);
+        FixedMultiplier<4> fixed4(ys[chunkSize - 1]);
+        FixedMultiplier<8> fixed8(ys[chunkSize - 1]);
+        for (size_t i = 0; i < chunkSize; ++i) {
+            const GF2m<>& a = xs[i];
+            const GF2m<>& b = ys[i];
+            reference[i] = a.multiplyMatrix(b);
+            if (i < 4 || i % 16 == 0) {
+                check(reference[i] == BitsetReference<>::multiply(a, b), "multiplyMatrix.bitset", i);
+                check(a.square() == BitsetReference<>::square(a), "square.bitset", i);
+                check(a.square() == BitsetReference<>::multiply(a, a), "square.bitsetMultiply", i);
             }
-            else if (hexChar >= 'A' && hexChar <= 'F') {
-                hexValue = hexChar - 'A' + 10;
+            check(a.multiplySparse(b) == reference[i], "multiplySparse", i);
+            check(a.multiplyPolynomial(b, clmulLimbsScalar<GF2m<>::words>) == reference[i], "multiplyPolynomial.scalar", i);
+#ifdef GF2M_X86
+            if (cpuSupportsClmul()) {
+                check(a.multiplyPolynomial(b, clmulLimbsHardware<GF2m<>::words>) == reference[i], "multiplyPolynomial.clmul", i);
             }
-            else if (hexChar >= 'a' && hexChar <= 'f') {
-                hexValue = hexChar - 'a' + 10;
-            }
-            else {
-                hexValue = -1; // Неправильний символ
+#endif
+            check(a.square() == a.multiplyMatrix(a), "square", i);
+            check(a.sqrt().square() == a, "sqrt", i);
+            GF2m<> scaled = a.multiplyMatrix(fixed4.operand());
+            check(fixed4.multiply(a) == scaled, "FixedMultiplier<4>", i);
+            check(fixed8.multiply(a) == scaled, "FixedMultiplier<8>", i);
+            // z^2 + z = c для c зі слідом 0; Tr(1) = 1 при непарному M, тож c = a або a + 1
+            GF2m<> c = a.trace() ? a + GF2m<>::one() : a;
+            GF2m<> z = c.solveQuadratic();
+            check(z.square() + z == c, "solveQuadratic", i);
+            GF2m<> h = a.halfTrace();
+            check(h.square() + h == c, "halfTrace", i);
+            check(GF2m<>::fromHex(a.toHex()) == a, "hex", i);
+            uint8_t bytes[GF2m<>::binaryBytes];
+            a.writeBytes(bytes);
+            check(GF2m<>::readBytes(bytes) == a, "bytes", i);
+        }
+        auto checkBatch = [&](auto lanesTag, const char* name) {
+            using Batch = GF2mBatch<decltype(lanesTag)::value>;
+            const std::string inverseName = std::string(name) + ".inverse", powName = std::string(name) + ".pow";
+            for (size_t begin = 0; begin < chunkSize; begin += Batch::lanes) {
+                size_t count = std::min<size_t>(Batch::lanes, chunkSize - begin);
+                std::vector<GF2m<>> products(count);
+                (Batch::load(std::span<const GF2m<>>(xs).subspan(begin, count)) * Batch::load(std::span<const GF2m<>>(ys).subspan(begin, count))).store(products);
+                for (size_t i = 0; i < count; ++i) check(products[i] == reference[begin + i], name, begin + i);
+                Batch::load(std::span<const GF2m<>>(xs).subspan(begin, count)).inverse().store(products);
+                for (size_t i = 0; i < count; ++i) {
+                    const GF2m<>& x = xs[begin + i];
+                    check(x.isZero() ? products[i].isZero() : products[i] == x.inverse(), inverseName.c_str(), begin + i);
+                }
+                // Піднесення до степеня - M пакетних множень, тож лише для першого пакета частини
+                if (begin != 0) continue;
+                const GF2m<>& shared = zs[chunkSize - 1];
+                Batch::load(std::span<const GF2m<>>(xs).first(count)).pow(shared).store(products);
+                for (size_t i = 0; i < count; ++i) check(products[i] == xs[i].powBinary(shared), powName.c_str(), i);
+                Batch::load(std::span<const GF2m<>>(xs).first(count)).pow(Batch::load(std::span<const GF2m<>>(ys).first(count))).store(products);
+                for (size_t i = 0; i < count; ++i) check(products[i] == xs[i].powBinary(ys[i]), (powName + "Lanes").c_str(), i);
             }
+        };
+        checkBatch(std::integral_constant<int, 1>{}, "GF2mBatch<1>");
+        checkBatch(std::integral_constant<int, 4>{}, "GF2mBatch<4>");
+        checkBatch(std::integral_constant<int, 8>{}, "GF2mBatch<8>");
 
-            if (hexValue == -1) {
-                throw std::invalid_argument("Неправильний символ у шістнадцятковому рядку");
-            }
-            for (int i = 3; i >= 0; --i) {
-                binStr += (hexValue & (1 << i)) ? '1' : '0';
+        // Таблиця гребінця, обчислена у процесі та відображена з файлу, що пише ця ж частина
+        const GF2m<>& base = zs[0];
+        FixedBasePow<4> computed(base);
+        auto path = std::filesystem::temp_directory_path() / ("gf2m_validate_" + std::to_string(chunkSeed) + ".bin");
+        computed.save(path.string());
+        {
+            FixedBasePow<4> loaded = FixedBasePow<4>::load(path.string(), base);
+            for (size_t i = 0; i < chunkSize; i += 16) {
+                GF2m<> expected = base.powBinary(ys[i]);
+                check(computed.pow(ys[i]) == expected, "FixedBasePow", i);
+                check(loaded.pow(ys[i]) == expected, "FixedBasePow.file", i);
             }
         }
-        // Обрізаємо старші нулі, якщо це необхідно
-        auto firstNonZero = binStr.find_first_not_of('0');
-        if (firstNonZero != std::string::npos) {
-            binStr = binStr.substr(firstNonZero);
-        }
-        if (binStr.size() > m) {
-            throw std::invalid_argument("Шістнадцятковий рядок занадто довгий");
-        }
-        // Доповнюємо рядок нулями зліва, якщо він коротший за m
-        if (binStr.size() < m) {
-            binStr = std::string(m - binStr.size(), '0') + binStr;
-        }
-        return GF2m(std::bitset<m>(binStr));
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        return;
     }
 
-    void print() const {
-        for (int i = m - 1; i >= 0; --i) {
-            std::cout << value.test(i);
+    for (size_t i = 0; i < chunkSize; ++i) {
+        const GF2m<>& a = xs[i];
+        const GF2m<>& b = ys[i];
+        const GF2m<>& c = zs[i];
+        GF2m<> ab = a.multiply(b);
+        check(ab == b.multiply(a), "commutativity", i);
+        check(a.multiply(b + c) == ab + a.multiply(c), "distributivity", i);
+        check(ab.multiply(c) == a.multiply(b.multiply(c)), "associativity", i);
+        check((a + b).trace() == (a.trace() ^ b.trace()), "trace", i);
+        typename GF2m<>::FusedSum sum;
+        sum.mulAdd(a, b);
+        sum.mulAdd(b, c);
+        check(sum.result() == ab + b.multiply(c), "FusedSum", i);
+        // Дорожчі перевірки - на кожній 16-й трійці
+        if (i % 16 != 0) continue;
+        if (!a.isZero()) {
+            check(a.multiply(a.inverse()) == GF2m<>::one(), "inverse", i);
+            // Одиниця нормального базису - усі біти 1, тобто як показник це 2^M - 1
+            check(a.pow(GF2m<>::one()) == GF2m<>::one(), "pow(2^M - 1)", i);
         }
-        std::cout << std::endl;
+        int window = 1 + static_cast<int>(i / 16) % GF2m<>::maxPowWindow;
+        check(a.powSliding(b, window) == a.powBinary(b), "powSliding", i);
+        typename GF2m<>::Accumulator product;
+        product.multiply(a);
+        product.multiply(b);
+        product.multiply(c);
+        check(product.result() == ab.multiply(c), "Accumulator", i);
     }
-
-    GF2m& operator=(const GF2m& other) {
-        if (this != &other) {
-            this->value = other.value;
-        }
-        return *this;
+    std::vector<GF2m<>> inverses(xs);
+    GF2m<>::batchInverse(inverses);
+    for (size_t i = 0; i < chunkSize; ++i) {
+        check(xs[i].isZero() ? inverses[i].isZero() : xs[i].multiply(inverses[i]) == GF2m<>::one(), "batchInverse", i);
     }
+    GF2m<> dot;
+    for (size_t i = 0; i < chunkSize; ++i) dot += xs[i].multiply(ys[i]);
+    check(GF2m<>::innerProduct(xs, ys) == dot, "innerProduct", 0);
+    // Остання частина може бути коротшою: основи та показники - непересічні половини xs та ys
+    const size_t powCount = std::min<size_t>(chunkSize / 2, 4);
+    std::span<const GF2m<>> bases(xs.data(), powCount), exponents(ys.data() + powCount, powCount);
+    GF2m<> powers = GF2m<>::one();
+    for (size_t i = 0; i < bases.size(); ++i) powers = powers.multiply(bases[i].powBinary(exponents[i]));
+    check(GF2m<>::multiPow(bases, exponents) == powers, "multiPow", 0);
 
-    bool operator==(const GF2m& other) const {
-        return value == other.value;
+    std::vector<GF2m<>> results(chunkSize);
+    parallel_inverse<m>(xs, results, pool);
+    for (size_t i = 0; i < chunkSize; ++i) {
+        check(xs[i].isZero() ? results[i].isZero() : xs[i].multiply(results[i]) == GF2m<>::one(), "parallel_inverse", i);
     }
+    const GF2m<>& power = zs[chunkSize - 1];
+    parallel_pow<m>(bases, power, std::span<GF2m<>>(results).first(powCount), pool);
+    for (size_t i = 0; i < powCount; ++i) check(results[i] == bases[i].powBinary(power), "parallel_pow", i);
 
-    GF2m operator+(const GF2m& other) const {
-        return this->add(other);
+    // Множення точки: kP на кривій через P = (x, y) та (k1 + k2)P = k1 P + k2 P.
+    // Скаляри до M біт, тож сума вміщається у M + 1 біт Scalar.
+    for (size_t i = 0; i < chunkSize; i += 128) {
+        AffinePoint<> P{ xs[i], ys[i] };
+        GF2m<> x2 = P.x.square();
+        // Точка, для якої b = 0, не визначає невироджену криву
+        if ((P.y.square() + P.x * P.y + x2 * P.x + x2).isZero()) continue;
+        BinaryCurve<> curve = BinaryCurve<>::throughPoint(GF2m<>::one(), P);
+        Scalar<> k1{}, k2{}, k12{};
+        std::copy(zs[i].limbs().begin(), zs[i].limbs().end(), k1.begin());
+        std::copy(ys[i].limbs().begin(), ys[i].limbs().end(), k2.begin());
+        unsigned carry = 0;
+        for (size_t w = 0; w < k12.size(); ++w) {
+            uint64_t sum = k1[w] + k2[w];
+            unsigned overflow = sum < k1[w];
+            k12[w] = sum + carry;
+            carry = overflow | (k12[w] < sum);
+        }
+        AffinePoint<> R1 = curve.toAffine(curve.multiply(k1, P)), R2 = curve.toAffine(curve.multiply(k2, P));
+        check(curve.isOnCurve(R1) && curve.isOnCurve(R2), "Curve::multiply.onCurve", i);
+        check(curve.toAffine(curve.multiply(k12, P)) == curve.addAffine(R1, R2), "Curve::multiply.linearity", i);
     }
+}
 
-    GF2m operator*(const GF2m& other) const {
-        return this->multiply(other);
+// iterations випадкових трійок частинами по chunkSize на пулі потоків. Тотожності перевіряються для
+// кожного доступного способу множення. Результат не залежить від кількості потоків.
+inline void runValidation(uint64_t seed, size_t iterations, ValidationReport& report, ThreadPool& pool = ThreadPool::global()) {
+    const size_t chunkSize = 512;
+    const size_t chunks = (iterations + chunkSize - 1) / chunkSize;
+    auto pass = [&](bool kernels, uint64_t salt) {
+        pool.parallelFor(chunks, 1, [&](size_t chunk, size_t, size_t) {
+            size_t count = std::min(chunkSize, iterations - chunk * chunkSize);
+            validateChunk(seed * 0x9E3779B97F4A7C15ULL + salt * 0x100000000ULL + chunk, count, kernels, report, pool);
+        });
+    };
+    pass(true, 0);
+    const MultiplyBackend selected = GF2m<>::getMultiplyBackend();
+    std::vector<MultiplyBackend> backends = { MultiplyBackend::Sparse, MultiplyBackend::PolynomialScalar };
+    if (cpuSupportsClmul()) backends.push_back(MultiplyBackend::PolynomialClmul);
+    for (MultiplyBackend backend : backends) {
+        GF2m<>::setMultiplyBackend(backend);
+        pass(false, 1 + static_cast<uint64_t>(backend));
     }
+    GF2m<>::setMultiplyBackend(selected);
+}
 
-    static void printMultiplicativeMatrix() {
-        for (int i = 0; i < m; ++i) {
-            for (int j = 0; j < m; ++j) {
-                std::cout << multiplicativeMatrix[i][j];
-            }
-            std::cout << std::endl;
-        }
-    }
+// Перевірка в тестах: на відміну від assert не зникає з NDEBUG. Помилка кидає TestFailure з
+// місцем та умовою; тип не походить від винятків, які тести перехоплюють навмисно.
+struct TestFailure : std::logic_error {
+    using std::logic_error::logic_error;
 };
 
+#define GF2M_CHECK(condition) \
+    ((condition) ? void() : throw TestFailure(std::string(__FILE__) + ":" + std::to_string(__LINE__) + ": " + #condition))
 
 void testAddition() {
     GF2m A1("01010000010111000001000101001010111010000100111100100000100110000100010101000001010110111110001101111101101101100101111001110110100011111011000001111101001111011011010010011");
     GF2m B1("01001001111011010100111010001010100001100000000110011011100010110000011100001000101011011110101001010011101111000110011100100001101101110000111000101010011000111011110011111");
-    assert(A1 + B1 == GF2m("00011001101100010101111111000000011011100100111010111011000100110100001001001001111101100000100100101110000010100011100101010111001110001011111001010111010111100000100001100"));
+    GF2M_CHECK(A1 + B1 == GF2m("00011001101100010101111111000000011011100100111010111011000100110100001001001001111101100000100100101110000010100011100101010111001110001011111001010111010111100000100001100"));
 
     GF2m A2("00101110101111100010010110001000001101101101100111001101010011111100011100011011111000100000010101101001010010011110101111010101010000101101100101110010111011001010011000100");
     GF2m B2("01101110101010111011100111101000101110110110010011100000011100011100111110010000000011111001000001001011000000111000000011001110011110101010001100110011100000111011011101011");
-    assert(A2 + B2 == GF2m("01000000000101011001110001100000100011011011110100101101001111100000100010001011111011011001010100100010010010100110101100011011001110000111101001000001011011110001000101111"));
+    GF2M_CHECK(A2 + B2 == GF2m("01000000000101011001110001100000100011011011110100101101001111100000100010001011111011011001010100100010010010100110101100011011001110000111101001000001011011110001000101111"));
 
     GF2m A3("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1);
     GF2m B3("0D5026BF220F27A2D765193E6C14502E37F19293A040", 1);
-    assert(A3 + B3 == GF2m("07B93B08D9DECC0EB17A7DB6A033A226F540A4DA9221", 1));
+    GF2M_CHECK(A3 + B3 == GF2m("07B93B08D9DECC0EB17A7DB6A033A226F540A4DA9221", 1));
 
     GF2m A4("17182F40654A23682F00C3790B2E6714CE97F804BFB4", 1);
     GF2m B4("08A7A2AAFB1EE180992EF7BD70265A48086F4B84842D", 1);
-    assert(A4 + B4 == GF2m("1FBF8DEA9E54C2E8B62E34C47B083D5CC6F8B3803B99", 1));
+    GF2M_CHECK(A4 + B4 == GF2m("1FBF8DEA9E54C2E8B62E34C47B083D5CC6F8B3803B99", 1));
 
     GF2m A5("ABCDEFABCEDFEACBDFEACABCDEFABCDEF", 1);
     GF2m B5("ABCDFAFACBACFACBACFACBACFACB", 1);
-    assert(A5 + B5 == GF2m("ABCDE5171170467110467073724073724", 1));
+    GF2M_CHECK(A5 + B5 == GF2m("ABCDE5171170467110467073724073724", 1));
 }
 void testMultiplication() {
     GF2m A1("01010000010111000001000101001010111010000100111100100000100110000100010101000001010110111110001101111101101101100101111001110110100011111011000001111101001111011011010010011");
     GF2m B1("01001001111011010100111010001010100001100000000110011011100010110000011100001000101011011110101001010011101111000110011100100001101101110000111000101010011000111011110011111");
-    assert(A1 * B1 == GF2m("00110110010010111111111110011011111000011000010101101111011000110110001001011011110000100111100000000011100100011011111000110011101101010010100111010110000011111111011110001"));
+    GF2M_CHECK(A1 * B1 == GF2m("00110110010010111111111110011011111000011000010101101111011000110110001001011011110000100111100000000011100100011011111000110011101101010010100111010110000011111111011110001"));
 
     GF2m A2("00101110101111100010010110001000001101101101100111001101010011111100011100011011111000100000010101101001010010011110101111010101010000101101100101110010111011001010011000100");
     GF2m B2("01101110101010111011100111101000101110110110010011100000011100011100111110010000000011111001000001001011000000111000000011001110011110101010001100110011100000111011011101011");
-    assert(A2 * B2 == GF2m("00010010110010001101111100010111000011111101111011111000110111100010111100110101011110010101010111001111110001111010000100011010011110001011011001110000000001110010100101110"));
+    GF2M_CHECK(A2 * B2 == GF2m("00010010110010001101111100010111000011111101111011111000110111100010111100110101011110010101010111001111110001111010000100011010011110001011011001110000000001110010100101110"));
 
     GF2m A3("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1);
     GF2m B3("0D5026BF220F27A2D765193E6C14502E37F19293A040", 1);
-    assert(A3 * B3 == GF2m("04B6D8DE392424850992E85DD6D258449A398E6ACA92", 1));
+    GF2M_CHECK(A3 * B3 == GF2m("04B6D8DE392424850992E85DD6D258449A398E6ACA92", 1));
 
     GF2m A4("17182F40654A23682F00C3790B2E6714CE97F804BFB4", 1);
     GF2m B4("08A7A2AAFB1EE180992EF7BD70265A48086F4B84842D", 1);
-    assert(A4 * B4 == GF2m("1FED401A3B3EDB2752315B4D38AF2556B9209DB1C927", 1));
+    GF2M_CHECK(A4 * B4 == GF2m("1FED401A3B3EDB2752315B4D38AF2556B9209DB1C927", 1));
 
     GF2m A5("ABCDEFABCEDFEACBDFEACABCDEFABCDEF", 1);
     GF2m B5("ABCDFAFACBACFACBACFACBACFACB", 1);
-    assert(A5 * B5 == GF2m("175EB77F6B38BC203C918B26A1BE56670C516D161455", 1));
+    GF2M_CHECK(A5 * B5 == GF2m("175EB77F6B38BC203C918B26A1BE56670C516D161455", 1));
+
+    // Усі реалізації множення мають збігатися з множенням за щільною матрицею
+    GF2M_CHECK(A1.multiplySparse(B1) == A1.multiplyMatrix(B1));
+    GF2M_CHECK(A3.multiplySparse(B3) == A3.multiplyMatrix(B3));
+    GF2M_CHECK(A5.multiplySparse(B5) == A5.multiplyMatrix(B5));
+    GF2M_CHECK(A1.multiplyPolynomial(B1, clmulLimbsScalar<GF2m<>::words>) == A1.multiplyMatrix(B1));
+    GF2M_CHECK(A3.multiplyPolynomial(B3, clmulLimbsScalar<GF2m<>::words>) == A3.multiplyMatrix(B3));
+    GF2M_CHECK(A5.multiplyPolynomial(B5, clmulLimbsScalar<GF2m<>::words>) == A5.multiplyMatrix(B5));
+#ifdef GF2M_X86
+    if (cpuSupportsClmul()) {
+        GF2M_CHECK(A1.multiplyPolynomial(B1, clmulLimbsHardware<GF2m<>::words>) == A1.multiplyMatrix(B1));
+        GF2M_CHECK(A5.multiplyPolynomial(B5, clmulLimbsHardware<GF2m<>::words>) == A5.multiplyMatrix(B5));
+    }
+#endif
+
+    // Множення на сталий множник через таблиці вікон
+    std::vector<GF2m<>> xs = randomElements(64, 5);
+    xs[0] = GF2m<>();
+    xs[1] = GF2m<>::one();
+    FixedMultiplier<1> fixed1(B1);
+    FixedMultiplier<4> fixed4(B1);
+    FixedMultiplier<8> fixed8(B1);
+    std::vector<GF2m<>> products(xs.size());
+    fixed4.multiply(xs, products);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        GF2m<> expected = xs[i].multiplyMatrix(B1);
+        GF2M_CHECK(fixed1.multiply(xs[i]) == expected);
+        GF2M_CHECK(fixed8.multiply(xs[i]) == expected);
+        GF2M_CHECK(products[i] == expected);
+    }
+    GF2M_CHECK(fixed4.multiply(GF2m<>::one()) == fixed4.operand());
 }
 void testTrace() {
     GF2m A1("0101000001011100000100010100101011101000010011100100000100110000100010101000001010110111110001101111101101101100101111001110110100011111011000001111101001111011011010010011");
-    assert(A1.trace() == 1);
+    GF2M_CHECK(A1.trace() == 1);
 
     GF2m A2("00101110101111100010010110001000001101101101100111001101010011111100011100011011111000100000010101101001010010011110101111010101010000101101100101110010111011001010011000100");
-    assert(A2.trace() == 0);
+    GF2M_CHECK(A2.trace() == 0);
 
     GF2m A3("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1);
-    assert(A3.trace() == 0);
+    GF2M_CHECK(A3.trace() == 0);
 
     GF2m A4("17182F40654A23682F00C3790B2E6714CE97F804BFB4", 1);
-    assert(A4.trace() == 0);
+    GF2M_CHECK(A4.trace() == 0);
 
     GF2m A5("ABCDEFABCEDFEACBDFEACABCDEFABCDEF", 1);
-    assert(A5.trace() == 0);
+    GF2M_CHECK(A5.trace() == 0);
 }
 void testSquare() {
     GF2m A1("01010000010111000001000101001010111010000100111100100000100110000100010101000001010110111110001101111101101101100101111001110110100011111011000001111101001111011011010010011");
-    assert(A1.square() == GF2m("10101000001011100000100010100101011101000010011110010000010011000010001010100000101011011111000110111110110110110010111100111011010001111101100000111110100111101101101001001"));
+    GF2M_CHECK(A1.square() == GF2m("10101000001011100000100010100101011101000010011110010000010011000010001010100000101011011111000110111110110110110010111100111011010001111101100000111110100111101101101001001"));
 
     GF2m A2("00101110101111100010010110001000001101101101100111001101010011111100011100011011111000100000010101101001010010011110101111010101010000101101100101110010111011001010011000100");
-    assert(A2.square() == GF2m("00010111010111110001001011000100000110110110110011100110101001111110001110001101111100010000001010110100101001001111010111101010101000010110110010111001011101100101001100010"));
+    GF2M_CHECK(A2.square() == GF2m("00010111010111110001001011000100000110110110110011100110101001111110001110001101111100010000001010110100101001001111010111101010101000010110110010111001011101100101001100010"));
 
     GF2m A3("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1);
-    assert(A3.square() == GF2m("15748EDBFDE8F5D6330FB2446613F90461589B249930", 1));
+    GF2M_CHECK(A3.square() == GF2m("15748EDBFDE8F5D6330FB2446613F90461589B249930", 1));
 
     GF2m A4("17182F40654A23682F00C3790B2E6714CE97F804BFB4", 1);
-    assert(A4.square() == GF2m("0B8C17A032A511B4178061BC8597338A674BFC025FDA", 1));
+    GF2M_CHECK(A4.square() == GF2m("0B8C17A032A511B4178061BC8597338A674BFC025FDA", 1));
 
     GF2m A5("ABCDEFABCEDFEACBDFEACABCDEFABCDEF", 1);
-    assert(A5.square() == GF2m("1000000000055E6F7D5E76FF565EFF5655E6F7D5E6F7", 1));
+    GF2M_CHECK(A5.square() == GF2m("1000000000055E6F7D5E76FF565EFF5655E6F7D5E6F7", 1));
+}
+void testRotate() {
+    GF2m A1("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1);
+    GF2M_CHECK(A1.rotate(1) == A1.square());
+    GF2M_CHECK(A1.rotate(m) == A1);
+    GF2M_CHECK(A1.rotate(-1).square() == A1);
+    GF2M_CHECK(A1.rotate(70) == A1.rotate(m + 70));
+
+    GF2m B1 = A1;
+    for (int i = 0; i < 100; ++i) B1 = B1.square();
+    GF2M_CHECK(A1.rotate(100) == B1);
+    GF2M_CHECK(GF2m<>::fromHex(A1.toHex()) == A1);
+    GF2M_CHECK(GF2m<>::fromString(A1.toString()) == A1);
 }
 void testPow() {
     GF2m A1("01010000010111000001000101001010111010000100111100100000100110000100010101000001010110111110001101111101101101100101111001110110100011111011000001111101001111011011010010011");
     GF2m B1("01001001111011010100111010001010100001100000000110011011100010110000011100001000101011011110101001010011101111000110011100100001101101110000111000101010011000111011110011111");
-    assert(A1.pow(B1) == GF2m("11111100101100000110000001100010001001110000001101000110111110111010011010000101100101011000110001111011000011010111001001011011111110011111001010101100000101111111110100001"));
+    GF2M_CHECK(A1.pow(B1) == GF2m("11111100101100000110000001100010001001110000001101000110111110111010011010000101100101011000110001111011000011010111001001011011111110011111001010101100000101111111110100001"));
 
     GF2m A2("00101110101111100010010110001000001101101101100111001101010011111100011100011011111000100000010101101001010010011110101111010101010000101101100101110010111011001010011000100");
     GF2m B2("01101110101010111011100111101000101110110110010011100000011100011100111110010000000011111001000001001011000000111000000011001110011110101010001100110011100000111011011101011");
-    assert(A2.pow(B2) == GF2m("10001000011010011001101010001100011111001011101010001101111100111110110110100110111110010001001001011111110001101110101100101100001101001101100010100100111110001001100001011"));
+    GF2M_CHECK(A2.pow(B2) == GF2m("10001000011010011001101010001100011111001011101010001101111100111110110110100110111110010001001001011111110001101110101100101100001101001101100010100100111110001001100001011"));
 
     GF2m A3("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1);
     GF2m B3("0D5026BF220F27A2D765193E6C14502E37F19293A040", 1);
-    assert(A3.pow(B3) == GF2m("194BC5F43C7CB6272885A87760EFA918B4A0C2A90E9F", 1));
+    GF2M_CHECK(A3.pow(B3) == GF2m("194BC5F43C7CB6272885A87760EFA918B4A0C2A90E9F", 1));
 
     GF2m A4("17182F40654A23682F00C3790B2E6714CE97F804BFB4", 1);
     GF2m B4("08A7A2AAFB1EE180992EF7BD70265A48086F4B84842D", 1);
-    assert(A4.pow(B4) == GF2m("1F48B2B63E96D443EDA95F0ED95B8D1B0FE6B0DEBAF8", 1));
+    GF2M_CHECK(A4.pow(B4) == GF2m("1F48B2B63E96D443EDA95F0ED95B8D1B0FE6B0DEBAF8", 1));
 
     GF2m A5("ABCDEFABCEDFEACBDFEACABCDEFABCDEF", 1);
     GF2m B5("ABCDFAFACBACFACBACFACBACFACB", 1);
-    assert(A5.pow(B5) == GF2m("06D515A93DCA0D686E6547B26608D78D24FACFF12FE2", 1));
+    GF2M_CHECK(A5.pow(B5) == GF2m("06D515A93DCA0D686E6547B26608D78D24FACFF12FE2", 1));
+
+    // Усі способи піднесення до степеня мають збігатися
+    for (int window = 1; window <= GF2m<>::maxPowWindow; ++window) {
+        GF2M_CHECK(A3.powSliding(B3, window) == A3.powBinary(B3));
+        GF2M_CHECK(A5.powSliding(B5, window) == A5.powBinary(B5));
+    }
+    FixedBasePow<> fixed3(A3);
+    FixedBasePow<4> fixed4(A4);
+    GF2M_CHECK(fixed3.pow(B3) == A3.pow(B3));
+    GF2M_CHECK(fixed3.pow(B5) == A3.pow(B5));
+    GF2M_CHECK(fixed4.pow(B4) == A4.pow(B4));
+    GF2M_CHECK(fixed3.pow(GF2m()) == GF2m<>::one());
+    GF2M_CHECK(A3.pow(GF2m()) == GF2m<>::one());
+
+    // multiPow збігається з добутком окремих степенів для кожної реалізації множення
+    std::vector<GF2m<>> bases = { A1, A2, A3, A4, A5, A1 + A2, A3 * A4, A5.square() };
+    std::vector<GF2m<>> exponents = { B1, B2, B3, B4, B5, B1 + B3, GF2m(), B2.rotate(3) };
+    const MultiplyBackend selected = GF2m<>::getMultiplyBackend();
+    for (MultiplyBackend backend : { MultiplyBackend::Sparse, MultiplyBackend::PolynomialScalar, selected }) {
+        GF2m<>::setMultiplyBackend(backend);
+        GF2m<> expected = GF2m<>::one();
+        for (size_t k = 0; k < bases.size(); ++k) {
+            expected = expected * bases[k].pow(exponents[k]);
+            std::span<const GF2m<>> b(bases.data(), k + 1), e(exponents.data(), k + 1);
+            GF2M_CHECK(GF2m<>::multiPow(b, e) == expected);
+            GF2M_CHECK(GF2m<>::multiPow(b, e, 2) == expected);
+        }
+        GF2M_CHECK(fixed4.pow(B4) == A4.powBinary(B4));
+    }
+    GF2m<>::setMultiplyBackend(selected);
+    GF2M_CHECK(GF2m<>::multiPow({}, {}) == GF2m<>::one());
 }
 void testInverse() {
     GF2m A1("01010000010111000001000101001010111010000100111100100000100110000100010101000001010110111110001101111101101101100101111001110110100011111011000001111101001111011011010010011");
-    assert(A1.inverse() == GF2m("11101101110101011000110000011011111000110101001100110101010001101101111100110101110101100101000101101101011010000000001101100011110100101100000001010101101001000111001100111"));
+    GF2M_CHECK(A1.inverse() == GF2m("11101101110101011000110000011011111000110101001100110101010001101101111100110101110101100101000101101101011010000000001101100011110100101100000001010101101001000111001100111"));
 
     GF2m A2("00101110101111100010010110001000001101101101100111001101010011111100011100011011111000100000010101101001010010011110101111010101010000101101100101110010111011001010011000100");
-    assert(A2.inverse() == GF2m("11000000011111011110000000001101110100111001110101111000111100010001001000001010011100000010010110111011010001000001110011111100001100011111100111111010011100000100110111111"));
+    GF2M_CHECK(A2.inverse() == GF2m("11000000011111011110000000001101110100111001110101111000111100010001001000001010011100000010010110111011010001000001110011111100001100011111100111111010011100000100110111111"));
 
     GF2m A3("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1);
-    assert(A3.inverse() == GF2m("0250F3C885BEAC3D7CFA993BDB13ED26E409392FEDC2", 1));
+    GF2M_CHECK(A3.inverse() == GF2m("0250F3C885BEAC3D7CFA993BDB13ED26E409392FEDC2", 1));
 
     GF2m A4("17182F40654A23682F00C3790B2E6714CE97F804BFB4", 1);
-    assert(A4.inverse() == GF2m("10B00FD70CED17CEF0200462504CBF3478D6B2C6B9DE", 1));
+    GF2M_CHECK(A4.inverse() == GF2m("10B00FD70CED17CEF0200462504CBF3478D6B2C6B9DE", 1));
 
     GF2m A5("ABCDEFABCEDFEACBDFEACABCDEFABCDEF", 1);
-    assert(A5.inverse() == GF2m("03F8E7199B0CCF8AA5167D40076A2F1755D52CC5238A", 1));
+    GF2M_CHECK(A5.inverse() == GF2m("03F8E7199B0CCF8AA5167D40076A2F1755D52CC5238A", 1));
+
+    // Ланцюжок для M - 1 = 172: 1, 2, 4, 5, 10, 20, 21, 42, 43, 86, 172
+    GF2M_CHECK(GF2m<>::getInversionChain().length == 11);
+
+    // Пакетне обернення збігається з поелементним, нулі залишаються нулями
+    std::vector<GF2m<>> elements = { A1, GF2m(), A2, A3, GF2m(), A4, A5 };
+    GF2m<>::batchInverse(elements);
+    GF2M_CHECK(elements[0] == A1.inverse() && elements[2] == A2.inverse() && elements[3] == A3.inverse());
+    GF2M_CHECK(elements[5] == A4.inverse() && elements[6] == A5.inverse());
+    GF2M_CHECK(elements[1] == GF2m() && elements[4] == GF2m());
+    std::vector<GF2m<>> single = { GF2m(), A3 };
+    GF2m<>::batchInverse(single);
+    GF2M_CHECK(single[1] == A3.inverse() && single[0] == GF2m());
+}
+void testStreamingIO() {
+    std::mt19937_64 gen(10);
+    std::vector<GF2m<>> elements(1000);
+    for (auto& x : elements) {
+        Limbs<m> limbs;
+        for (auto& word : limbs) word = gen() >> (gen() % 64);
+        x = GF2m<>(limbs);
+    }
+    elements[0] = GF2m();
+
+    // Буфер навмисно малий, щоб перевірити спорожнення
+    std::vector<char> buffer(4096);
+    std::string hexText, binaryText;
+    HexWriter<> hexWriter(buffer);
+    for (const auto& x : elements) {
+        if (!hexWriter.write(x)) {
+            hexText.append(hexWriter.data().begin(), hexWriter.data().end());
+            hexWriter.clear();
+            hexWriter.write(x);
+        }
+    }
+    hexText.append(hexWriter.data().begin(), hexWriter.data().end());
+    BinaryWriter<> binaryWriter(buffer);
+    for (const auto& x : elements) {
+        if (!binaryWriter.write(x)) {
+            binaryText.append(binaryWriter.data().begin(), binaryWriter.data().end());
+            binaryWriter.clear();
+            binaryWriter.write(x);
+        }
+    }
+    binaryText.append(binaryWriter.data().begin(), binaryWriter.data().end());
+    GF2M_CHECK(binaryText.size() == elements.size() * 22);
+
+    auto path = std::filesystem::temp_directory_path() / "gf2m_io_test.txt";
+    std::ofstream(path, std::ios::binary) << hexText;
+    {
+        MappedFile file(path.string());
+        HexReader<> reader(file.data());
+        GF2m<> x;
+        size_t count = 0;
+        while (reader.next(x)) {
+            GF2M_CHECK(x == elements[count]);
+            GF2M_CHECK(x == GF2m<>::fromHex(x.toHex()));
+            ++count;
+        }
+        GF2M_CHECK(count == elements.size());
+    }
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << binaryText;
+    {
+        MappedFile file(path.string());
+        BinaryReader<> reader(file.data());
+        GF2M_CHECK(reader.size() == elements.size());
+        for (size_t i = 0; i < reader.size(); ++i) GF2M_CHECK(reader[i] == elements[i]);
+    }
+    std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+    {
+        MappedFile file(path.string());
+        HexReader<> reader(file.data());
+        GF2m<> x;
+        GF2M_CHECK(file.data().empty() && !reader.next(x));
+    }
+    std::filesystem::remove(path);
+
+    // Лідуючі нулі дозволені, зайві біти та неправильні символи - ні
+    GF2M_CHECK(GF2m<>::fromHex("0000000000001ABC") == GF2m<>::fromHex("1abc"));
+    GF2M_CHECK(GF2m<>::fromHex("1FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF") == GF2m<>::one());
+    for (const char* bad : { "2FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", "100000000000000000000000000000000000000000000", "12G4" }) {
+        bool thrown = false;
+        try {
+            GF2m<>::fromHex(bad);
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        GF2M_CHECK(thrown);
+    }
+}
+void testTableFile() {
+    GF2m<> base("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1);
+    GF2m<> power("0D5026BF220F27A2D765193E6C14502E37F19293A040", 1);
+    std::string path = (std::filesystem::temp_directory_path() / "gf2m_table_test.bin").string();
+    std::filesystem::remove(path);
+
+    // Файлу немає - таблиця обчислюється у процесі
+    FixedBasePow<> computed = FixedBasePow<>::loadOrCompute(path, base);
+    GF2M_CHECK(!computed.isMapped());
+    computed.save(path);
+    FixedBasePow<> mapped = FixedBasePow<>::load(path, base);
+    GF2M_CHECK(mapped.isMapped() && mapped.base() == base);
+    GF2M_CHECK(mapped.pow(power) == base.pow(power));
+    FixedBasePow<> copy = mapped;
+    GF2M_CHECK(copy.pow(power) == base.pow(power));
+
+    auto throwsOnLoad = [&](auto load) {
+        try {
+            load();
+        }
+        catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    GF2M_CHECK(throwsOnLoad([&] { FixedBasePow<>::load(path, power); }));
+    GF2M_CHECK(throwsOnLoad([&] { FixedBasePow<4>::load(path, base); }));
+    try {
+        FixedBasePow<4>::load(path, base);
+    }
+    catch (const std::runtime_error& e) {
+        // Файл іншої кількості зубців називає обидві конфігурації
+        GF2M_CHECK(std::string(e.what()).find("8 зубців; очікується m = 173, 4 зубців") != std::string::npos);
+    }
+    GF2M_CHECK(throwsOnLoad([&] { FixedBasePow<8, 131>::load(path, GF2m<131>()); }));
+
+    // Пошкоджений запис: контрольна сума не збігається, loadOrCompute обчислює таблицю
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(TableFileHeader) + 100);
+        file.put('\x5A');
+    }
+    GF2M_CHECK(throwsOnLoad([&] { FixedBasePow<>::load(path, base); }));
+    FixedBasePow<> fallback = FixedBasePow<>::loadOrCompute(path, base);
+    GF2M_CHECK(!fallback.isMapped() && fallback.pow(power) == base.pow(power));
+
+#ifndef _WIN32
+    // Перезапис файлу, який ще відображено: старе відображення бачить старий файл
+    FixedBasePow<>(power).save(path);
+    GF2M_CHECK(mapped.pow(power) == base.pow(power));
+    GF2M_CHECK(FixedBasePow<>::load(path, power).pow(base) == power.pow(base));
+#endif
+    // Одночасні записи того самого файлу: кожен пише власний тимчасовий файл, результат - цілий
+    {
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) writers.emplace_back([&] { FixedBasePow<>(base).save(path); });
+        for (std::thread& writer : writers) writer.join();
+    }
+    GF2M_CHECK(FixedBasePow<>::load(path, base).pow(power) == base.pow(power));
+    const std::string prefix = std::filesystem::path(path).filename().string() + ".";
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::path(path).parent_path())) {
+        GF2M_CHECK(entry.path().filename().string().rfind(prefix, 0) != 0);
+    }
+    std::filesystem::remove(path);
+}
+void testQuadratic() {
+    GF2m A1("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1);
+    GF2m A2("17182F40654A23682F00C3790B2E6714CE97F804BFB4", 1);
+    GF2M_CHECK(A1.sqrt().square() == A1);
+    // sqrt(a) = a^(2^(m-1))
+    GF2M_CHECK(A2.sqrt() == A2.pow(GF2m<>::fromString("1" + std::string(m - 1, '0'))));
+
+    // H(c) = сума c^(2^(2i)) за означенням
+    for (const GF2m<>& c : { A1, A2, GF2m<>::one(), GF2m<>() }) {
+        GF2m<> expected;
+        for (int i = 0; i <= (m - 1) / 2; ++i) expected = expected + c.rotate(2 * i);
+        GF2m<> h = c.halfTrace();
+        GF2M_CHECK(h == expected);
+        GF2M_CHECK(h.square() + h == (c.trace() ? c + GF2m<>::one() : c));
+    }
+
+    std::mt19937_64 gen(9);
+    for (int n = 0; n < 20; ++n) {
+        Limbs<m> x;
+        for (auto& word : x) word = gen();
+        GF2m<> c(x);
+        if (c.trace()) {
+            bool thrown = false;
+            try {
+                c.solveQuadratic();
+            }
+            catch (const std::domain_error&) {
+                thrown = true;
+            }
+            GF2M_CHECK(thrown);
+            continue;
+        }
+        GF2m<> z = c.solveQuadratic();
+        GF2M_CHECK(z.square() + z == c);
+    }
+}
+void testCurve() {
+    // Криву будуємо через задану точку, b обчислюється з рівняння
+    AffinePoint<> P{ GF2m("0AE91DB7FBD1EBAC661F6488CC27F208C2B136493261", 1), GF2m("0D5026BF220F27A2D765193E6C14502E37F19293A040", 1) };
+    BinaryCurve<> curve = BinaryCurve<>::throughPoint(GF2m<>::one(), P);
+    GF2M_CHECK(curve.isOnCurve(P));
+
+    AffinePoint<> P2 = curve.addAffine(P, P);
+    AffinePoint<> P3 = curve.addAffine(P2, P);
+    GF2M_CHECK(curve.isOnCurve(P2) && curve.isOnCurve(P3));
+    GF2M_CHECK(curve.toAffine(curve.dbl(curve.toProjective(P))) == P2);
+    GF2M_CHECK(curve.toAffine(curve.addMixed(curve.toProjective(P2), P)) == P3);
+    GF2M_CHECK(curve.toAffine(curve.addMixed(curve.toProjective(P), P)) == P2);
+    GF2M_CHECK(curve.toAffine(curve.addMixed(curve.toProjective(P), curve.negate(P))).infinity);
+    GF2M_CHECK(curve.decompress(P.x, curve.compressionBit(P)) == P);
+    GF2M_CHECK(curve.decompress(P3.x, curve.compressionBit(P3)) == P3);
+    GF2M_CHECK(curve.decompress(P3.x, 1 - curve.compressionBit(P3)) == curve.negate(P3));
+
+    std::mt19937_64 gen(8);
+    std::vector<Scalar<>> scalars = { Scalar<>{ 0 }, Scalar<>{ 1 }, Scalar<>{ 2 }, Scalar<>{ 3 } };
+    for (int i = 0; i < 4; ++i) {
+        Scalar<> k;
+        for (auto& word : k) word = gen();
+        k.back() &= (static_cast<uint64_t>(1) << (m + 1 - 64 * (k.size() - 1))) - 1;
+        scalars.push_back(k);
+    }
+    std::vector<AffinePoint<>> points(scalars.size(), P3);
+    std::vector<AffinePoint<>> batch = curve.multiplyBatch(scalars, points);
+    GF2M_CHECK(batch[0].infinity && batch[1] == P3 && batch[2] == curve.addAffine(P3, P3));
+    for (size_t i = 0; i < scalars.size(); ++i) {
+        GF2M_CHECK(batch[i] == curve.toAffine(curve.multiply(scalars[i], P3)));
+        GF2M_CHECK(batch[i] == curve.toAffine(curve.multiplyDoubleAdd(scalars[i], P3)));
+        GF2M_CHECK(curve.isOnCurve(batch[i]));
+    }
+    // (k + 1) P = kP + P
+    Scalar<> k = scalars[5], k1 = k;
+    ++k1[0];
+    GF2M_CHECK(curve.toAffine(curve.multiply(k1, P)) == curve.addAffine(curve.toAffine(curve.multiply(k, P)), P));
+}
+template <int W>
+void testBatchLanes() {
+    std::mt19937_64 gen(173);
+    const int count = GF2mBatch<W>::lanes - 3;
+    std::vector<GF2m<>> a(count), b(count), e(count);
+    for (int i = 0; i < count; ++i) {
+        Limbs<m> x, y, z;
+        for (int j = 0; j < GF2m<>::words; ++j) {
+            x[j] = gen();
+            y[j] = gen();
+            z[j] = gen();
+        }
+        a[i] = GF2m(x);
+        b[i] = GF2m(y);
+        e[i] = GF2m(z);
+    }
+    auto A = GF2mBatch<W>::load(a);
+    auto B = GF2mBatch<W>::load(b);
+    auto E = GF2mBatch<W>::load(e);
+    GF2mBatch<W> sum = A + B, product = A * B, square = A.square(), inverse = A.inverse();
+    GF2mBatch<W> power = A.pow(e[0]), lanePower = A.rotate(5).pow(E);
+    std::vector<GF2m<>> out(count);
+    product.store(out);
+    for (int i = 0; i < count; ++i) {
+        GF2M_CHECK(out[i] == a[i] * b[i]);
+        GF2M_CHECK(sum.get(i) == a[i] + b[i]);
+        GF2M_CHECK(square.get(i) == a[i].square());
+        GF2M_CHECK(inverse.get(i) == a[i].inverse());
+        GF2M_CHECK(power.get(i) == a[i].pow(e[0]));
+        GF2M_CHECK(lanePower.get(i) == a[i].rotate(5).pow(e[i]));
+    }
+    // Порожні доріжки: 0 * x = 0, обернений до нуля залишається нулем
+    GF2M_CHECK(product.get(count) == GF2m());
+    GF2M_CHECK(inverse.get(count) == GF2m());
+
+    GF2mBatch<W> C = A;
+    C.set(1, b[1]);
+    GF2M_CHECK(C.get(1) == b[1] && C.get(0) == a[0]);
+    GF2M_CHECK(A.rotate(m) == A);
+}
+void testBatch() {
+    testBatchLanes<1>();
+    testBatchLanes<4>();
+    testBatchLanes<8>();
+}
+// Інші розміри поля з ONB типу II: усі реалізації множення та обернення мають узгоджуватися
+template <int M>
+void testFieldSize() {
+    std::mt19937_64 gen(M);
+    for (int n = 0; n < 5; ++n) {
+        Limbs<M> x, y;
+        for (int j = 0; j < GF2m<M>::words; ++j) {
+            x[j] = gen();
+            y[j] = gen();
+        }
+        GF2m<M> a(x), b(y);
+        GF2m<M> product = a.multiplyMatrix(b);
+        GF2M_CHECK(a.multiplySparse(b) == product);
+        GF2M_CHECK(a.multiplyPolynomial(b, clmulLimbsScalar<GF2m<M>::words>) == product);
+        GF2M_CHECK(a * b == product);
+        GF2M_CHECK(a * a.inverse() == GF2m<M>::one());
+        GF2M_CHECK(a.rotate(M) == a);
+        GF2M_CHECK((FixedMultiplier<4, M>(b).multiply(a) == product));
+    }
+    std::vector<GF2m<M>> lanes(64);
+    for (auto& lane : lanes) {
+        Limbs<M> x;
+        for (auto& word : x) word = gen();
+        lane = GF2m<M>(x);
+    }
+    auto A = GF2mBatch<1, M>::load(lanes);
+    auto product = A * A.rotate(3);
+    for (int i = 0; i < 64; ++i) GF2M_CHECK(product.get(i) == lanes[i] * lanes[i].rotate(3));
+}
+void testFieldSizes() {
+    testFieldSize<131>();
+    testFieldSize<179>();
+    testFieldSize<233>();
+}
+void testPoly() {
+    auto randomPoly = [](size_t size, uint64_t seed) {
+        return GF2mPoly<>(randomElements(size, seed));
+    };
+    // Карацуба збігається з множенням стовпчиком, зокрема для різних довжин
+    for (auto [n, k] : { std::pair<size_t, size_t>{ 1, 1 }, { 5, 20 }, { 17, 17 }, { 40, 33 }, { 70, 20 }, { 10, 90 } }) {
+        GF2mPoly<> a = randomPoly(n, n), b = randomPoly(k, 100 + k);
+        GF2M_CHECK(a * b == a.multiplyNaive(b));
+        GF2M_CHECK(a * b == b * a);
+    }
+    GF2M_CHECK((GF2mPoly<>() * randomPoly(3, 1)).isZero());
+
+    // Ділення стовпчиком і через обернений ряд: a = q b + r, deg r < deg b
+    for (auto [n, d] : { std::pair<size_t, size_t>{ 10, 3 }, { 200, 40 }, { 300, 120 }, { 5, 9 } }) {
+        GF2mPoly<> a = randomPoly(n, 7 * n), b = randomPoly(d, 11 * d);
+        auto [q, r] = a.divide(b);
+        GF2M_CHECK(q * b + r == a);
+        GF2M_CHECK(r.degree() < b.degree());
+    }
+
+    GF2mPoly<> f = randomPoly(60, 3);
+    std::vector<GF2m<>> points = randomElements(150, 4);
+    std::vector<GF2m<>> expected(points.size());
+    for (size_t i = 0; i < points.size(); ++i) expected[i] = f.evaluate(points[i]);
+    GF2M_CHECK(f.evaluateHorner(points) == expected);
+    GF2M_CHECK(f.evaluateHorner<1>(points) == expected);
+    GF2M_CHECK(f.evaluateTree(points) == expected);
+
+    // Інтерполяція відновлює многочлен за deg + 1 точками
+    std::span<const GF2m<>> xs(points.data(), 60);
+    GF2M_CHECK(GF2mPoly<>::interpolate(xs, std::span<const GF2m<>>(expected.data(), 60)) == f);
+    std::vector<GF2m<>> duplicate = { points[0], points[1], points[0] };
+    bool thrown = false;
+    try {
+        GF2mPoly<>::interpolate(duplicate, std::span<const GF2m<>>(expected.data(), 3));
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    GF2M_CHECK(thrown);
+    GF2M_CHECK(GF2mPoly<>::linear(points[0]).derivative() == GF2mPoly<>(std::vector<GF2m<>>{ GF2m<>::one() }));
+}
+// Без GF2M_INSTRUMENT перевіряти нічого
+void testInstrumentation() {
+#ifdef GF2M_INSTRUMENT
+    std::vector<GF2m<>> xs = randomElements(8, 17);
+    Instrumentation::setSampleInterval(1);
+    Instrumentation::reset();
+    {
+        Instrumentation::Scope outer("outer");
+        for (int i = 0; i < 3; ++i) xs[i] = xs[i].inverse();
+        {
+            Instrumentation::Scope inner("inner");
+            xs[3] = xs[3].square();
+            xs[4] = xs[4].pow(xs[5]);
+            GF2M_CHECK(inner.calls(FieldOperation::Pow) == 1);
+            GF2M_CHECK(inner.calls(FieldOperation::Inverse) == 0);
+        }
+        GF2M_CHECK(outer.calls(FieldOperation::Inverse) == 3);
+        GF2M_CHECK(outer.calls(FieldOperation::Pow) == 1);
+        // inverse множить через multiply: вкладені виклики теж рахуються
+        GF2M_CHECK(outer.calls(FieldOperation::Multiply) >= 3 * (GF2m<>::getInversionChain().length - 1));
+    }
+    // Лічильники завершеного потоку не губляться
+    std::thread([&] { GF2m<>::batchInverse(xs); }).join();
+
+    Instrumentation::Snapshot snapshot = Instrumentation::snapshot();
+    GF2M_CHECK(snapshot.calls[static_cast<int>(FieldOperation::Inverse)] == 4);
+    GF2M_CHECK(snapshot.calls[static_cast<int>(FieldOperation::BatchInverse)] == 1);
+    GF2M_CHECK(snapshot.calls[static_cast<int>(FieldOperation::Square)] >= 1);
+    const Instrumentation::Histogram& h = snapshot.latency[static_cast<int>(FieldOperation::Inverse)];
+    GF2M_CHECK(h.samples == 4);
+    GF2M_CHECK(h.percentileNs(0.5) <= h.percentileNs(0.99) && h.percentileNs(0.99) <= h.maxNs);
+    GF2M_CHECK(snapshot.scopes.size() == 2 && snapshot.scopes[0].first == "inner" && snapshot.scopes[1].first == "outer");
+    GF2M_CHECK(snapshot.toJson().find("\"inverse\": {\"calls\": 4") != std::string::npos);
+    GF2M_CHECK(snapshot.toText().find("фаза outer:") != std::string::npos);
+
+    // Множення через Accumulator та FusedSum теж рахуються
+    Instrumentation::reset();
+    {
+        Instrumentation::Scope scope("quote\" back\\slash\n");
+        xs[0].pow(xs[1]);
+        GF2m<>::innerProduct(xs, xs);
+        GF2M_CHECK(scope.calls(FieldOperation::Multiply) > xs.size());
+    }
+    GF2M_CHECK(Instrumentation::snapshot().toJson().find("\"quote\\\" back\\\\slash\\u000a\": {") != std::string::npos);
+
+    // FixedBasePow - це pow, multiPow - pow на кожен доданок; пакети та parallel_* рахуються у фазі викликача,
+    // разом з операціями, які задачі виконали на робочих потоках
+    {
+        Instrumentation::Scope scope("kernels");
+        FixedBasePow<4>(xs[0]).pow(xs[1]);
+        GF2m<>::multiPow(std::span<const GF2m<>>(xs).first(2), std::span<const GF2m<>>(xs).last(2));
+        GF2M_CHECK(scope.calls(FieldOperation::Pow) == 3);
+        GF2mBatch<1> lanes = GF2mBatch<1>::load(xs);
+        lanes.multiply(lanes).inverse().pow(xs[2]);
+        GF2M_CHECK(scope.calls(FieldOperation::LanesInverse) == 1 && scope.calls(FieldOperation::LanesPow) == 1);
+        GF2M_CHECK(scope.calls(FieldOperation::LanesMultiply) > 1);
+        ThreadPool pool(2);
+        std::vector<GF2m<>> many = randomElements(4000, 18), out(many.size());
+        parallel_pow<m>(many, xs[3], out, pool);
+        parallel_inverse<m>(many, out, pool);
+        parallel_sum<m>(many, pool);
+        GF2M_CHECK(scope.calls(FieldOperation::Parallel) == 3);
+        GF2M_CHECK(scope.calls(FieldOperation::Pow) == 3 + many.size());
+        GF2M_CHECK(scope.calls(FieldOperation::BatchInverse) >= 1);
+    }
+
+    Instrumentation::reset();
+    GF2M_CHECK(Instrumentation::snapshot().calls[static_cast<int>(FieldOperation::Inverse)] == 0);
+    Instrumentation::setSampleInterval(64);
+#endif
+}
+
+void testEval() {
+    std::vector<GF2m<>> xs = randomElements(700, 23), ys = randomElements(700, 24);
+    std::string input;
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        EvalOperation op = static_cast<EvalOperation>(i % static_cast<size_t>(EvalOperation::Count));
+        input += std::string(evalOperationNames[static_cast<int>(op)]) + " " + xs[i].toHex();
+        if (evalOperandCount(op) == 2) input += " " + ys[i].toHex();
+        input += i % 50 ? "\n" : "\n\n";
+        switch (op) {
+        case EvalOperation::Add: expected.push_back((xs[i] + ys[i]).toHex()); break;
+        case EvalOperation::Multiply: expected.push_back(xs[i].multiply(ys[i]).toHex()); break;
+        case EvalOperation::Square: expected.push_back(xs[i].square().toHex()); break;
+        case EvalOperation::Sqrt: expected.push_back(xs[i].sqrt().toHex()); break;
+        case EvalOperation::Inverse: expected.push_back(xs[i].inverse().toHex()); break;
+        case EvalOperation::Pow: expected.push_back(xs[i].pow(ys[i]).toHex()); break;
+        default: expected.push_back(std::to_string(xs[i].trace()));
+        }
+    }
+    input += "inv 0\nmul 1\ndiv 1 2\nsqr XYZ\n";
+    const size_t errorLines = 4;
+
+    // Розмір порції не впливає на відповіді, зокрема коли межа порції припадає на кінець вводу
+    for (size_t batchSize : { size_t{ 1 }, size_t{ 37 }, xs.size() + errorLines, size_t{ 4096 } }) {
+        std::istringstream in(input);
+        std::ostringstream out;
+        GF2M_CHECK(evaluateStream(in, out, false, batchSize) == errorLines);
+        std::istringstream lines(out.str());
+        std::string line;
+        for (const std::string& e : expected) {
+            std::getline(lines, line);
+            GF2M_CHECK(line == e);
+        }
+        for (size_t i = 0; i < errorLines; ++i) {
+            std::getline(lines, line);
+            GF2M_CHECK(line.rfind("error: ", 0) == 0);
+        }
+        GF2M_CHECK(!std::getline(lines, line));
+    }
+
+    // Двійковий формат: ті ж множення та обернення
+    std::string records;
+    for (size_t i = 0; i < 600; ++i) {
+        char record[1 + 2 * GF2m<>::binaryBytes] = {};
+        record[0] = static_cast<char>(i % 2 ? EvalOperation::Multiply : EvalOperation::Inverse);
+        xs[i].writeBytes(reinterpret_cast<uint8_t*>(record + 1));
+        ys[i].writeBytes(reinterpret_cast<uint8_t*>(record + 1 + GF2m<>::binaryBytes));
+        records.append(record, sizeof(record));
+    }
+    records.append(1, static_cast<char>(EvalOperation::Add));
+    std::istringstream in(records);
+    std::ostringstream out;
+    GF2M_CHECK(evaluateStream(in, out, true, 256) == 1);
+    std::string answers = out.str();
+    const size_t answerBytes = 1 + GF2m<>::binaryBytes;
+    GF2M_CHECK(answers.size() == 601 * answerBytes);
+    for (size_t i = 0; i < 600; ++i) {
+        GF2M_CHECK(answers[i * answerBytes] == 0);
+        GF2m<> result = GF2m<>::readBytes(reinterpret_cast<const uint8_t*>(answers.data() + i * answerBytes + 1));
+        GF2M_CHECK(result == (i % 2 ? xs[i].multiply(ys[i]) : xs[i].inverse()));
+    }
+    GF2M_CHECK(answers[600 * answerBytes] == 1);
+
+    // Ввід через std::cin, прив'язаний до std::cout, як у "eval < файл": порції по одному
+    // запиту, тож читання та запис відповідей постійно перетинаються
+    std::string sums;
+    for (size_t i = 0; i < 3000; ++i) sums += "add " + xs[i % xs.size()].toHex() + " " + ys[i % 7].toHex() + "\n";
+    std::istringstream stdinText(sums);
+    std::ostringstream stdoutText;
+    std::streambuf* cinBuffer = std::cin.rdbuf(stdinText.rdbuf());
+    std::streambuf* coutBuffer = std::cout.rdbuf(stdoutText.rdbuf());
+    size_t stdinErrors = evaluateStream(std::cin, std::cout, false, 1);
+    std::cin.rdbuf(cinBuffer);
+    std::cout.rdbuf(coutBuffer);
+    std::cin.clear();
+    GF2M_CHECK(stdinErrors == 0 && std::cin.tie() == &std::cout);
+    std::istringstream sumLines(stdoutText.str());
+    std::string sumLine;
+    for (size_t i = 0; i < 3000; ++i) {
+        std::getline(sumLines, sumLine);
+        GF2M_CHECK(sumLine == (xs[i % xs.size()] + ys[i % 7]).toHex());
+    }
+    GF2M_CHECK(!std::getline(sumLines, sumLine));
+}
+
+void testValidation() {
+    ValidationReport report;
+    runValidation(7, 1100, report);
+    GF2M_CHECK(report.failures.load() == 0 && report.messages.empty());
+    GF2M_CHECK(report.checks.load() > 1100 * 10);
+    // Коротка остання частина (515 = 512 + 3) та частина з одного елемента
+    for (size_t count : { size_t{ 515 }, size_t{ 3 }, size_t{ 1 } }) {
+        ValidationReport shortReport;
+        runValidation(8, count, shortReport);
+        GF2M_CHECK(shortReport.failures.load() == 0 && shortReport.checks.load() > 0);
+    }
+}
+
+void testParallel() {
+    std::vector<GF2m<>> input = randomElements(5000, 12);
+    input[17] = GF2m();
+    GF2m<> power("0D5026BF220F27A2D765193E6C14502E37F19293A040", 1);
+
+    std::vector<GF2m<>> powers(input.size()), inverses(input.size());
+    GF2m<> product = GF2m<>::one(), sum;
+    for (size_t i = 0; i < input.size(); ++i) {
+        powers[i] = input[i].pow(power);
+        inverses[i] = input[i].isZero() ? GF2m() : input[i].inverse();
+        product = product * input[i];
+        sum = sum + input[i];
+    }
+
+    // Результати не залежать від кількості потоків
+    for (size_t threads : { 1, 3, 8 }) {
+        ThreadPool pool(threads);
+        std::vector<GF2m<>> out(input.size());
+        parallel_pow(input, power, out, pool);
+        GF2M_CHECK(out == powers);
+        parallel_inverse(input, out, pool);
+        GF2M_CHECK(out == inverses);
+        GF2M_CHECK(parallel_product(input, pool) == product);
+        GF2M_CHECK(parallel_sum(input, pool) == sum);
+        std::vector<int> traces(input.size());
+        parallel_map(input, traces, [](const GF2m<>& x) { return x.trace(); }, pool);
+        for (size_t i = 0; i < input.size(); ++i) GF2M_CHECK(traces[i] == input[i].trace());
+
+        // Виняток з однієї з частин перекидається у викликаючий потік
+        bool thrown = false;
+        try {
+            parallel_map(input, out, [](const GF2m<>& x) { return x.inverse(); }, pool);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        GF2M_CHECK(thrown);
+
+        // Вкладені parallelFor: потік, що чекає на свої частини, не блокує їх виконання
+        std::atomic<size_t> visited{ 0 };
+        pool.parallelFor(16, 1, [&](size_t, size_t, size_t) {
+            pool.parallelFor(64, 4, [&](size_t, size_t begin, size_t end) { visited.fetch_add(end - begin); });
+        });
+        GF2M_CHECK(visited.load() == 16 * 64);
+    }
+    GF2M_CHECK(parallel_sum(std::span<const GF2m<>>()) == GF2m());
 }
 void otherTests() {
     std::bitset<173> bitset;
     bitset.set(); // Встановлює всі біти у 1
-    GF2m Max(bitset);
+    GF2m<> Max(bitset);
     GF2m a("1E5908188E2D4E112EC2B9F5EBDBE7703651A1A520DC", 1);
     GF2m b("0ACE832553C6A2574E988BD34ED55D7918BEDFC36474", 1);
     GF2m c("008B945DE1FD63598C82DC661E9EB94757153572503E", 1);
 
     //(a+b)c=c(a+b)=ac+bc
-    assert((a + b) * c == a * c + b * c);
-    assert((a + b) * c == c * (a + b));
+    GF2M_CHECK((a + b) * c == a * c + b * c);
+    GF2M_CHECK((a + b) * c == c * (a + b));
     //a^Max=1
-    assert(a.pow(Max) == GF2m("1FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", 1));
+    GF2M_CHECK(a.pow(Max) == GF2m("1FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", 1));
+    GF2M_CHECK(GF2m<>::one() == GF2m("1FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", 1));
 }
+void testFused() {
+    std::vector<GF2m<>> xs = randomElements(100, 14), ys = randomElements(100, 15);
+    const MultiplyBackend selected = GF2m<>::getMultiplyBackend();
+    for (MultiplyBackend backend : { MultiplyBackend::Sparse, MultiplyBackend::PolynomialScalar, selected }) {
+        GF2m<>::setMultiplyBackend(backend);
+        GF2m<> expected, acc;
+        GF2m<>::FusedSum fused;
+        for (size_t i = 0; i < xs.size(); ++i) {
+            expected = expected + xs[i].multiply(ys[i]);
+            mulAdd(acc, xs[i], ys[i]);
+            mulAdd(fused, xs[i], ys[i]);
+        }
+        GF2M_CHECK(innerProduct(xs, ys) == expected);
+        GF2M_CHECK(acc == expected && fused.result() == expected);
 
+        // operator* одразу дає елемент поля, тож auto та виклики методів на добутку працюють як раніше
+        auto product = xs[0] * ys[0];
+        static_assert(std::is_same_v<decltype(product), GF2m<>>);
+        GF2M_CHECK((xs[0] * ys[0]).toHex() == xs[0].multiply(ys[0]).toHex());
+        GF2M_CHECK((xs[0] * ys[0]).trace() == product.trace() && product.multiply(product.inverse()) == GF2m<>::one());
+        GF2M_CHECK(xs[0] * ys[0] + xs[1] * ys[1] == innerProduct(std::span(xs).first(2), std::span(ys).first(2)));
 
-std::string generateRandomNumberString(int length) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 1); // generating digits between 0 and 9
-
-    std::string result;
-    for (int i = 0; i < length; ++i) {
-        result += std::to_string(dis(gen));
+        GF2m<> z = xs[5];
+        z *= ys[5];
+        GF2M_CHECK(z == xs[5].multiply(ys[5]));
+        z += xs[6];
+        GF2M_CHECK(z == xs[5].multiply(ys[5]) + xs[6]);
     }
-    return result;
+    GF2m<>::setMultiplyBackend(selected);
+    GF2M_CHECK(innerProduct({}, {}) == GF2m());
 }
-void timeTest() {
 
-    GF2m numbers[20];
-    for (int i = 0; i < 20; i++) {
-        GF2m temp(generateRandomNumberString(173));
-        numbers[i] = temp;
-    }
-    GF2m a;
-    int b;
-    auto start = std::chrono::high_resolution_clock::now();
-    for (int i = 1; i < 1001; i++) {
-        a = numbers[i % 20] + numbers[(i - 1) % 20];
-    }
-    auto stop = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-    std::cout << "Time taken for addition: " << duration.count() << " microseconds." << std::endl;
 
+// Бар'єр, що не дає компілятору викинути обчислення результату. В asm передається адреса, а не
+// саме значення: великі T (GF2mBatch, FixedBasePow) не вміщаються в регістр, а "memory" змушує
+// записати значення в пам'ять за цією адресою.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#ifdef __GNUC__
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#endif
+}
+
+inline uint64_t readCycleCounter() {
+#ifdef GF2M_X86
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
 
-    start = std::chrono::high_resolution_clock::now();
-    for (int i = 1; i < 101; i++) {
-        a = numbers[i % 20] * numbers[(i - 1) % 20];
-    }
-    stop = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-    std::cout << "Time taken for multiplication: " << duration.count() << " microseconds." << std::endl;
+struct BenchResult {
+    std::string name;
+    int opsPerSample;
+    double medianNs, p99Ns, medianCycles, p99Cycles;
+};
 
-    start = std::chrono::high_resolution_clock::now();
-    for (int i = 1; i < 1001; i++) {
-        b = numbers[i % 20].trace();
+// samples вимірювань по opsPerSample викликів op(i) після warmup прогрівальних вимірювань;
+// результат - час та такти на одну операцію
+template <typename Op>
+BenchResult runBenchmark(const std::string& name, int opsPerSample, int samples, Op op) {
+    const int warmup = std::max(1, samples / 10);
+    std::vector<double> ns, cycles;
+    for (int s = 0; s < warmup + samples; ++s) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t startCycles = readCycleCounter();
+        for (int i = 0; i < opsPerSample; ++i) op(i);
+        uint64_t stopCycles = readCycleCounter();
+        auto stop = std::chrono::steady_clock::now();
+        if (s < warmup) continue;
+        ns.push_back(std::chrono::duration<double, std::nano>(stop - start).count() / opsPerSample);
+        cycles.push_back(static_cast<double>(stopCycles - startCycles) / opsPerSample);
     }
-    stop = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-    std::cout << "Time taken for trace: " << duration.count() << " microseconds." << std::endl;
+    std::sort(ns.begin(), ns.end());
+    std::sort(cycles.begin(), cycles.end());
+    size_t median = ns.size() / 2, p99 = std::min(ns.size() - 1, ns.size() * 99 / 100);
+    return { name, opsPerSample, ns[median], ns[p99], cycles[median], cycles[p99] };
+}
 
-    start = std::chrono::high_resolution_clock::now();
-    for (int i = 1; i < 1001; i++) {
-        a = numbers[i % 20].square();
+std::string backendName(MultiplyBackend backend) {
+    switch (backend) {
+    case MultiplyBackend::PolynomialClmul: return "clmul";
+    case MultiplyBackend::PolynomialScalar: return "polynomial";
+    default: return "sparse";
     }
-    stop = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-    std::cout << "Time taken for square: " << duration.count() << " microseconds." << std::endl;
+}
+
+template <int W>
+void benchmarkBatch(std::vector<BenchResult>& results, const std::vector<GF2m<>>& inputs) {
+    const int lanes = GF2mBatch<W>::lanes;
+    std::vector<GF2m<>> first(inputs.begin(), inputs.begin() + lanes), second(inputs.end() - lanes, inputs.end());
+    auto A = GF2mBatch<W>::load(first), B = GF2mBatch<W>::load(second);
+    std::string suffix = "<" + std::to_string(W) + ">";
+    // Час на одну доріжку: операція над пакетом ділиться на lanes
+    auto perLane = [lanes](BenchResult r) {
+        r.medianNs /= lanes;
+        r.p99Ns /= lanes;
+        r.medianCycles /= lanes;
+        r.p99Cycles /= lanes;
+        return r;
+    };
+    results.push_back(perLane(runBenchmark("batch" + suffix + ".multiply", 4, 50, [&](int) { doNotOptimize(A * B); })));
+    results.push_back(perLane(runBenchmark("batch" + suffix + ".inverse", 1, 20, [&](int) { doNotOptimize(A.inverse()); })));
+    results.push_back(perLane(runBenchmark("batch" + suffix + ".load+store", 4, 50, [&](int) {
+        GF2mBatch<W>::load(first).store(second);
+        doNotOptimize(second);
+    })));
+}
 
+// Режим bench: фіксовані вхідні дані, прогрівання, медіана та 99-й перцентиль на операцію
+int runBench(bool json) {
+    const std::vector<GF2m<>> inputs = randomElements(1024, 173);
+    const size_t mask = inputs.size() - 1;
+    auto x = [&](int i) -> const GF2m<>& { return inputs[static_cast<size_t>(i) & mask]; };
+    auto y = [&](int i) -> const GF2m<>& { return inputs[static_cast<size_t>(i * 7 + 3) & mask]; };
+    const MultiplyBackend defaultBackend = GF2m<>::getMultiplyBackend();
 
-    start = std::chrono::high_resolution_clock::now();
-    for (int i = 1; i < 11; i++) {
-        a = numbers[i % 20].pow(numbers[(i - 1) % 20]);
+    std::vector<BenchResult> results;
+    results.push_back(runBenchmark("add", 1000, 200, [&](int i) { doNotOptimize(x(i) + y(i)); }));
+    results.push_back(runBenchmark("square", 1000, 200, [&](int i) { doNotOptimize(x(i).square()); }));
+    results.push_back(runBenchmark("rotate", 1000, 200, [&](int i) { doNotOptimize(x(i).rotate(i % m)); }));
+    results.push_back(runBenchmark("trace", 1000, 200, [&](int i) { doNotOptimize(x(i).trace()); }));
+    results.push_back(runBenchmark("halfTrace", 1000, 200, [&](int i) { doNotOptimize(x(i).halfTrace()); }));
+    std::vector<MultiplyBackend> backends = { MultiplyBackend::Sparse, MultiplyBackend::PolynomialScalar };
+    if (cpuSupportsClmul()) backends.push_back(MultiplyBackend::PolynomialClmul);
+    for (MultiplyBackend backend : backends) {
+        GF2m<>::setMultiplyBackend(backend);
+        results.push_back(runBenchmark("multiply." + backendName(backend), 100, 200, [&](int i) { doNotOptimize(x(i).multiply(y(i))); }));
+    }
+    FixedMultiplier<4> fixed4(inputs[5]);
+    FixedMultiplier<8> fixed8(inputs[5]);
+    results.push_back(runBenchmark("fixedMultiplier<4>", 100, 200, [&](int i) { doNotOptimize(fixed4.multiply(x(i))); }));
+    results.push_back(runBenchmark("fixedMultiplier<8>", 100, 200, [&](int i) { doNotOptimize(fixed8.multiply(x(i))); }));
+    results.push_back(runBenchmark("fixedMultiplier<4>.build", 1, 20, [&](int i) { doNotOptimize(FixedMultiplier<4>(x(i))); }));
+    GF2m<>::setMultiplyBackend(defaultBackend);
+    results.push_back(runBenchmark("pow", 10, 100, [&](int i) { doNotOptimize(x(i).pow(y(i))); }));
+    results.push_back(runBenchmark("powBinary", 10, 50, [&](int i) { doNotOptimize(x(i).powBinary(y(i))); }));
+    std::span<const GF2m<>> xs(inputs.data(), 64), ys(inputs.data() + 64, 64);
+    results.push_back(runBenchmark("innerProduct(64)/term", 1, 100, [&](int) { doNotOptimize(innerProduct(xs, ys)); }));
+    results.push_back(runBenchmark("multiply+add(64)/term", 1, 100, [&](int) {
+        GF2m<> sum;
+        for (size_t i = 0; i < xs.size(); ++i) sum += xs[i].multiply(ys[i]);
+        doNotOptimize(sum);
+    }));
+    for (size_t n = results.size() - 2; n < results.size(); ++n) {
+        results[n].medianNs /= 64;
+        results[n].p99Ns /= 64;
+        results[n].medianCycles /= 64;
+        results[n].p99Cycles /= 64;
     }
-    stop = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-    std::cout << "Time taken for pow: " << duration.count() << " microseconds." << std::endl;
+    std::string tablePath = (std::filesystem::temp_directory_path() / "gf2m_bench_table.bin").string();
+    FixedBasePow<>(inputs[0]).save(tablePath);
+    results.push_back(runBenchmark("fixedBasePow.compute", 1, 20, [&](int) { doNotOptimize(FixedBasePow<>(inputs[0])); }));
+    results.push_back(runBenchmark("fixedBasePow.load", 1, 50, [&](int) { doNotOptimize(FixedBasePow<>::load(tablePath, inputs[0])); }));
+    std::filesystem::remove(tablePath);
+    FixedBasePow<> fixed(inputs[0]);
+    results.push_back(runBenchmark("fixedBasePow", 10, 100, [&](int i) { doNotOptimize(fixed.pow(y(i))); }));
+    results.push_back(runBenchmark("inverse", 10, 100, [&](int i) { doNotOptimize(x(i).inverse()); }));
+    std::vector<GF2m<>> scratch(inputs);
+    results.push_back(runBenchmark("batchInverse(1024)/element", 1, 50, [&](int) {
+        std::copy(inputs.begin(), inputs.end(), scratch.begin());
+        GF2m<>::batchInverse(scratch);
+        doNotOptimize(scratch);
+    }));
+    results.back().medianNs /= 1024;
+    results.back().p99Ns /= 1024;
+    results.back().medianCycles /= 1024;
+    results.back().p99Cycles /= 1024;
+    benchmarkBatch<1>(results, inputs);
+    benchmarkBatch<4>(results, inputs);
+    benchmarkBatch<8>(results, inputs);
 
+    AffinePoint<> P{ inputs[1], inputs[2] };
+    BinaryCurve<> curve = BinaryCurve<>::throughPoint(GF2m<>::one(), P);
+    Scalar<> k{ inputs[3].limbs()[0], inputs[3].limbs()[1], inputs[3].limbs()[2] };
+    results.push_back(runBenchmark("curve.ladder", 1, 30, [&](int) { doNotOptimize(curve.multiply(k, P)); }));
 
+    char text[GF2m<>::hexDigits];
+    results.push_back(runBenchmark("writeHex", 1000, 100, [&](int i) { doNotOptimize(x(i).writeHex(text)); }));
+    std::vector<std::string> hex(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) hex[i] = inputs[i].toHex();
+    results.push_back(runBenchmark("parseHex", 1000, 100, [&](int i) {
+        const std::string& h = hex[static_cast<size_t>(i) & mask];
+        doNotOptimize(GF2m<>::parseHex(h.data(), h.data() + h.size()));
+    }));
 
-    start = std::chrono::high_resolution_clock::now();
-    for (int i = 1; i < 11; i++) {
-        a = numbers[i % 20].inverse();
+    if (json) {
+        std::cout << "{\n  \"m\": " << m << ",\n  \"defaultBackend\": \"" << backendName(defaultBackend) << "\",\n"
+                  << "  \"clmul\": " << (cpuSupportsClmul() ? "true" : "false")
+                  << ",\n  \"avx2\": " << (cpuSupportsAvx2() ? "true" : "false")
+                  << ",\n  \"avx512\": " << (cpuSupportsAvx512() ? "true" : "false") << ",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            std::cout << "    {\"name\": \"" << r.name << "\", \"opsPerSample\": " << r.opsPerSample
+                      << ", \"medianNs\": " << r.medianNs << ", \"p99Ns\": " << r.p99Ns
+                      << ", \"medianCycles\": " << r.medianCycles << ", \"p99Cycles\": " << r.p99Cycles
+                      << ", \"opsPerSecond\": ";
+            // Медіана 0 нс (операція коротша за роздільність годинника) дала б inf - не JSON
+            if (r.medianNs > 0) std::cout << 1e9 / r.medianNs;
+            else std::cout << "null";
+            std::cout << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        std::cout << "  ]";
+#ifdef GF2M_INSTRUMENT
+        std::cout << ",\n  \"instrumentation\": " << Instrumentation::snapshot().toJson();
+#endif
+        std::cout << "\n}\n";
+    }
+    else {
+        std::cout << "m = " << m << ", множення за замовчуванням: " << backendName(defaultBackend) << "\n";
+        for (const BenchResult& r : results) {
+            std::cout << r.name << ": " << r.medianNs << " ns (p99 " << r.p99Ns << " ns), "
+                      << r.medianCycles << " тактів (p99 " << r.p99Cycles << ")\n";
+        }
+#ifdef GF2M_INSTRUMENT
+        std::cout << Instrumentation::snapshot().toText();
+#endif
     }
-    stop = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-    std::cout << "Time taken for inverse: " << duration.count() << " microseconds." << std::endl;
+    return 0;
+}
+
 
+// Числовий аргумент командного рядка: увесь рядок має бути числом, без винятків
+template <typename T>
+bool parseArgument(const std::string& text, T& value) {
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
 }
 
+// Записує таблицю з Teeth зубцями і перевіряє файл так само, як його перевірятиме load
+template <int Teeth>
+size_t writeTable(const std::string& path, const GF2m<>& base) {
+    FixedBasePow<Teeth>(base).save(path);
+    FixedBasePow<Teeth>::load(path, base);
+    return FixedBasePow<Teeth>::entries;
+}
+
+// Режим gen-tables: таблиця FixedBasePow для основи у шістнадцятковому вигляді.
+// --teeth обирає кількість зубців гребінця (4, 8, 12 або 16, за замовчуванням 8); файл
+// завантажується лише FixedBasePow з тією ж кількістю зубців.
+int runGenTables(const std::vector<std::string>& args) {
+    const char* usage = "Використання: gen-tables [--teeth 4|8|12|16] <файл> <основа у hex>\n";
+    int teeth = 8;
+    std::vector<std::string> positional;
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "--teeth" && i + 1 < args.size() && parseArgument(args[i + 1], teeth) && teeth % 4 == 0 && teeth >= 4 && teeth <= 16) {
+            ++i;
+        }
+        else if (args[i].empty() || args[i][0] != '-') {
+            positional.push_back(args[i]);
+        }
+        else {
+            std::cerr << usage;
+            return 2;
+        }
+    }
+    if (positional.size() != 2) {
+        std::cerr << usage;
+        return 2;
+    }
+    const std::string& path = positional[0];
+    size_t entries = 0;
+    try {
+        GF2m<> base = GF2m<>::fromHex(positional[1]);
+        switch (teeth) {
+        case 4: entries = writeTable<4>(path, base); break;
+        case 12: entries = writeTable<12>(path, base); break;
+        case 16: entries = writeTable<16>(path, base); break;
+        default: entries = writeTable<8>(path, base);
+        }
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Неправильна основа: " << e.what() << "\n" << usage;
+        return 2;
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    std::cout << "Записано " << entries << " елементів (m = " << m << ", " << teeth << " зубців) у " << path << "\n";
+    return 0;
+}
 
+// Режим validate: "validate [--seed S] [--count N]" - одна перевірка, "--fuzz [--seconds T]" -
+// повтори з новими зернами, доки не мине T секунд (0 - без обмеження) або не знайдеться помилка.
+// За замовчуванням 2^14 трійок (близько 10 с на одному ядрі); довші перевірки - через --count або --fuzz.
+int runValidate(const std::vector<std::string>& args) {
+    uint64_t seed = 1;
+    size_t count = static_cast<size_t>(1) << 14;
+    bool fuzz = false;
+    double seconds = 0;
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "--seed" && i + 1 < args.size() && parseArgument(args[i + 1], seed)) {
+            ++i;
+        }
+        else if (args[i] == "--count" && i + 1 < args.size() && parseArgument(args[i + 1], count)) {
+            ++i;
+        }
+        else if (args[i] == "--seconds" && i + 1 < args.size() && parseArgument(args[i + 1], seconds) && seconds >= 0) {
+            ++i;
+        }
+        else if (args[i] == "--fuzz") {
+            fuzz = true;
+        }
+        else {
+            std::cerr << "Використання: validate [--seed S] [--count N] [--fuzz [--seconds T]]\n";
+            return 2;
+        }
+    }
+    ValidationReport report;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t round = 0;; ++round) {
+        runValidation(seed + round, count, report);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "seed " << seed + round << ": " << report.checks.load() << " перевірок, " << report.failures.load()
+                  << " помилок, " << elapsed << " с" << std::endl;
+        if (!fuzz || report.failures.load() != 0 || (seconds > 0 && elapsed >= seconds)) break;
+    }
+    for (const std::string& message : report.messages) std::cout << message << "\n";
+    return report.failures.load() == 0 ? 0 : 1;
+}
 
+// Режим eval: запити з файлу або stdin (формати - див. evaluateStream), відповіді у stdout.
+// Код повернення 1, якщо хоча б один запит завершився помилкою. Порція не більша за
+// maxBatch запитів: у пам'яті одночасно дві порції, тож більше значення лише витрачає пам'ять.
+int runEval(const std::vector<std::string>& args) {
+    const size_t maxBatch = static_cast<size_t>(1) << 20;
+    bool binary = false;
+    size_t batchSize = 4096;
+    std::string path;
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "--binary") {
+            binary = true;
+        }
+        else if (args[i] == "--batch" && i + 1 < args.size() && parseArgument(args[i + 1], batchSize) && batchSize > 0 && batchSize <= maxBatch) {
+            ++i;
+        }
+        else if (path.empty() && args[i][0] != '-') {
+            path = args[i];
+        }
+        else {
+            std::cerr << "Використання: eval [--binary] [--batch <кількість, 1..1048576>] [файл]\n";
+            return 2;
+        }
+    }
+    std::ifstream file;
+    if (!path.empty()) {
+        file.open(path, binary ? std::ios::binary : std::ios::in);
+        if (!file) {
+            std::cerr << "Не вдалося відкрити " << path << "\n";
+            return 2;
+        }
+    }
+#ifdef _WIN32
+    if (binary) {
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+    std::ios::sync_with_stdio(false);
+    size_t errors = evaluateStream(path.empty() ? std::cin : file, std::cout, binary, batchSize);
+    return errors ? 1 : 0;
+}
 
+// Режим test: усі набори тестів по черзі. Код повернення 1 на першій невдалій перевірці.
+int runTests() {
+    const std::pair<const char*, void (*)()> suites[] = {
+        { "addition", testAddition }, { "multiplication", testMultiplication }, { "square", testSquare },
+        { "rotate", testRotate }, { "inverse", testInverse }, { "pow", testPow }, { "batch", testBatch },
+        { "field sizes", testFieldSizes }, { "quadratic", testQuadratic }, { "curve", testCurve },
+        { "streaming I/O", testStreamingIO }, { "table file", testTableFile }, { "poly", testPoly },
+        { "instrumentation", testInstrumentation }, { "parallel", testParallel }, { "eval", testEval },
+        { "validation", testValidation }, { "fused", testFused }, { "other", otherTests }, { "trace", testTrace },
+    };
+    for (const auto& [name, suite] : suites) {
+        try {
+            suite();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Тест " << name << " не пройшов: " << e.what() << "\n";
+            return 1;
+        }
+        std::cout << "Тест " << name << ": ok" << std::endl;
+    }
+    std::cout << "Всі тести пройшли успішно!\n";
+    return 0;
+}
 
-MultiplicativeMatrix GF2m::multiplicativeMatrix(m);
-int main() {
-    GF2m::calculateMultiplicativeMatrix();
+// Режими: без аргументів - демонстрація, "test" - усі тести, "bench [--json]" - вимірювання продуктивності,
+// "gen-tables [--teeth T] <файл> <основа>" - файл таблиці для FixedBasePow::load,
+// "eval [--binary] [--batch N] [файл]" - пакетне обчислення запитів,
+// "validate [--seed S] [--count N] [--fuzz [--seconds T]]" - перевірка всіх реалізацій
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (!args.empty() && args[0] == "bench") {
+        return runBench(args.size() > 1 && args[1] == "--json");
+    }
+    if (!args.empty() && args[0] == "gen-tables") {
+        return runGenTables(args);
+    }
+    if (!args.empty() && args[0] == "eval") {
+        return runEval(args);
+    }
+    if (!args.empty() && args[0] == "test") {
+        return runTests();
+    }
+    if (!args.empty() && args[0] == "validate") {
+        return runValidate(args);
+    }
 
-    /*timeTest();
-    testAddition();
-    testMultiplication();
-    testSquare();
-    testInverse();
-    testPow();
-    otherTests();
-    testTrace();
-    std::cout << "Всі тести пройшли успішно!\n";*/
-    
     GF2m a("1C610FA72B082905FB7D0597D754DDF64330A6E38D87", 1);
     GF2m b("1322645130758ED775F543D63398E11C2FC9BD377E4E", 1);
     GF2m c("1311EF56624F81C6C43609B74687D8BAF7E0916BDD1E", 1);